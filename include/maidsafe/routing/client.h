@@ -40,6 +40,7 @@
 
 #include "maidsafe/routing/bootstrap_handler.h"
 #include "maidsafe/routing/peer_node.h"
+#include "maidsafe/routing/routing_config.h"
 #include "maidsafe/routing/sentinel.h"
 #include "maidsafe/routing/types.h"
 #include "maidsafe/routing/messages/messages_fwd.h"
@@ -51,9 +52,21 @@ namespace routing {
 
 class Client : public std::enable_shared_from_this<Client> {
  public:
-  Client(asio::io_service& io_service, Identity our_id, asymm::Keys our_keys);
-  Client(asio::io_service& io_service, const passport::Maid& maid);
-  Client(asio::io_service& io_service, const passport::Mpid& mpid);
+  // Each constructor throws CommonErrors::invalid_argument if 'config' fails validation.
+  Client(asio::io_service& io_service, Identity our_id, asymm::Keys our_keys,
+         RoutingConfig config = RoutingConfig());
+  Client(asio::io_service& io_service, const passport::Maid& maid,
+         RoutingConfig config = RoutingConfig());
+  Client(asio::io_service& io_service, const passport::Mpid& mpid,
+         RoutingConfig config = RoutingConfig());
+  // As above, but network I/O runs on 'crux_asio_service' rather than on a thread of the client's
+  // own, so that many clients in one process can share it.  It must outlive the client.
+  Client(BoostAsioService& crux_asio_service, asio::io_service& io_service, Identity our_id,
+         asymm::Keys our_keys, RoutingConfig config = RoutingConfig());
+  Client(BoostAsioService& crux_asio_service, asio::io_service& io_service,
+         const passport::Maid& maid, RoutingConfig config = RoutingConfig());
+  Client(BoostAsioService& crux_asio_service, asio::io_service& io_service,
+         const passport::Mpid& mpid, RoutingConfig config = RoutingConfig());
   Client() = delete;
   Client(const Client&) = delete;
   Client(Client&&) = delete;
@@ -83,6 +96,9 @@ class Client : public std::enable_shared_from_this<Client> {
   Address OurId() const { return our_id_; }
 
  private:
+  Client(BoostAsioService* crux_asio_service, asio::io_service& io_service, Identity our_id,
+         asymm::Keys our_keys, RoutingConfig config);
+
   void MessageReceived(const Address& peer_id, SerialisedMessage message);
   void ConnectionLost(const Address& peer_id);
 
@@ -94,7 +110,9 @@ class Client : public std::enable_shared_from_this<Client> {
   void HandleMessage(routing::Post&& post);
   void HandleMessage(PostResponse&& post_response);
 
-  BoostAsioService crux_asio_service_;
+  const RoutingConfig config_;
+  std::unique_ptr<BoostAsioService> owned_crux_asio_service_;
+  BoostAsioService& crux_asio_service_;
   asio::io_service& io_service_;
   const Address our_id_;
   const asymm::Keys our_keys_;
@@ -0,0 +1,81 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_ROUTING_CONFIG_H_
+#define MAIDSAFE_ROUTING_ROUTING_CONFIG_H_
+
+#include <chrono>
+#include <cstdint>
+
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Performance parameters for a RoutingNode or Client.  The defaults are the values previously
+// hard-coded; deployments may tune them without rebuilding.
+struct RoutingConfig {
+  // Throws CommonErrors::invalid_argument if any parameter is out of range.
+  void Validate() const;
+
+  // Threads for network I/O and for request/crypto work respectively.  Ignored where the node is
+  // given externally owned services.  Everything run on the crux service relies on it having a
+  // single thread, so crux_thread_count must be 1.
+  unsigned crux_thread_count = 1;
+  unsigned worker_thread_count = 4;
+  // How long a message id is remembered to drop duplicates, how long data is cached and how long
+  // Sentinel waits for a quorum of messages or keys.
+  std::chrono::seconds filter_time_to_live = std::chrono::minutes(20);
+  std::chrono::seconds cache_time_to_live = std::chrono::minutes(60);
+  std::chrono::seconds sentinel_time_to_live = std::chrono::minutes(20);
+  // How long a GetData error response validated by Sentinel is remembered, so that we don't ask
+  // again for missing data.  Kept short as the data may yet be stored; at most the cache period.
+  std::chrono::seconds negative_cache_time_to_live = std::chrono::seconds(30);
+  // Receive buffer per peer (and so the largest message accepted) and for the connect handshake.
+  size_t max_message_size = DefaultMaxMessageSize;
+  size_t exchange_buffer_size = DefaultExchangeBufferSize;
+  HopLimit hop_limit = DefaultHopLimit;
+  // Every message we send carries a deadline this far ahead, once past which nodes drop it rather
+  // than route or handle it.  Nodes' clocks are assumed to agree to well within this.
+  std::chrono::seconds request_timeout = std::chrono::seconds(30);
+  // Bytes queued to a peer beyond which it is passed over for an equally close, less busy one.
+  size_t congested_peer_bytes = 256 * 1024;
+  // Size of the shared memory ring carrying messages to each peer on the same host in place of
+  // UDP, or 0 to always use UDP.  Larger messages, or any while the ring is full, still go by UDP.
+  size_t shared_memory_ring_bytes = 1024 * 1024;
+  // Accepts kept outstanding on each listening port, so that a burst of incoming connects is
+  // taken up without waiting for each accept to be re-armed.
+  unsigned pending_accepts_per_port = 8;
+  // Data we put of at least this many bytes is compressed where it looks compressible, or 0 to
+  // never compress.  Whoever receives it decodes no more than max_message_size bytes of it.
+  size_t compress_payload_bytes = 4096;
+  // How long each round of the FindGroup lookup made when joining waits for its answers.
+  std::chrono::milliseconds lookup_round_timeout = std::chrono::seconds(5);
+  // How often buckets beyond our close group are checked for staleness and refreshed.
+  std::chrono::seconds bucket_refresh_interval = std::chrono::minutes(1);
+  // Longest time between republishing our PublicPmid to our group; must be well within the cache
+  // period of the nodes holding it.  Each period is jittered down by up to a quarter.
+  std::chrono::seconds key_republish_interval = std::chrono::minutes(8);
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_ROUTING_CONFIG_H_
@@ -19,17 +19,23 @@
 #ifndef MAIDSAFE_ROUTING_ROUTING_NODE_H_
 #define MAIDSAFE_ROUTING_ROUTING_NODE_H_
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <future>
 #include <memory>
 #include <utility>
 #include <map>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include "asio/io_service.hpp"
 #include "asio/post.hpp"
 #include "asio/use_future.hpp"
 #include "asio/ip/udp.hpp"
+#include "boost/asio/steady_timer.hpp"
 #include "boost/filesystem/path.hpp"
 #include "boost/expected/expected.hpp"
 
@@ -42,11 +48,22 @@
 #include "maidsafe/passport/types.h"
 
 #include "maidsafe/routing/bootstrap_handler.h"
+#include "maidsafe/routing/bucket_refresh_scheduler.h"
+#include "maidsafe/routing/congestion_windows.h"
 #include "maidsafe/routing/connection_manager.h"
 #include "maidsafe/routing/message_header.h"
 #include "maidsafe/routing/messages/messages.h"
 #include "maidsafe/routing/endpoint_pair.h"
+#include "maidsafe/routing/find_group_response_cache.h"
+#include "maidsafe/routing/group_key_prefetcher.h"
+#include "maidsafe/routing/group_lookup.h"
+#include "maidsafe/routing/payload_encoding.h"
+#include "maidsafe/routing/republish_scheduler.h"
+#include "maidsafe/routing/request_coalescer.h"
+#include "maidsafe/routing/routing_config.h"
+#include "maidsafe/routing/seen_from.h"
 #include "maidsafe/routing/sentinel.h"
+#include "maidsafe/routing/signature_scheme.h"
 #include "maidsafe/routing/types.h"
 
 namespace maidsafe {
@@ -59,7 +76,45 @@ class RoutingNode {
   using SendHandler = std::function<void(asio::error_code)>;
 
  public:
+  // Counts of traffic the node has chosen not to handle or forward.  Safe to read from any thread.
+  struct Counters {
+    std::atomic<uint64_t> expired_dropped{0};
+    std::atomic<uint64_t> hop_limit_dropped{0};
+    std::atomic<uint64_t> forwards_suppressed{0};
+    // rounds and FindGroup messages taken by the most recent lookup of our close group
+    std::atomic<uint64_t> join_lookup_rounds{0};
+    std::atomic<uint64_t> join_lookup_messages{0};
+    // hops taken by messages delivered to us which carried our hop limit, and their number; the
+    // mean stays near log2 of the network size while buckets are kept fresh
+    std::atomic<uint64_t> hops_total{0};
+    std::atomic<uint64_t> hops_measured{0};
+    std::atomic<uint64_t> bucket_refreshes{0};
+    std::atomic<uint64_t> key_republishes{0};
+    // FindGroup requests answered without signing afresh
+    std::atomic<uint64_t> find_group_signatures_reused{0};
+    // GetData requests held behind an identical one in flight, responses copied back to them, and
+    // those held so long they were sent on after all
+    std::atomic<uint64_t> get_data_coalesced{0};
+    std::atomic<uint64_t> get_data_fanned_out{0};
+    std::atomic<uint64_t> get_data_coalesce_expired{0};
+    // our own GetData requests not sent, as the data's group recently told us it is missing
+    std::atomic<uint64_t> get_data_misses_answered{0};
+    // messages we marked congestion-experienced while forwarding them, and our own requests held
+    // back, or dropped, as the window towards their destination was full
+    std::atomic<uint64_t> congestion_marked{0};
+    std::atomic<uint64_t> requests_held{0};
+    std::atomic<uint64_t> requests_dropped{0};
+  };
+
   RoutingNode();
+  // Throws CommonErrors::invalid_argument if 'config' fails validation.
+  explicit RoutingNode(RoutingConfig config);
+  // Runs the node on externally owned services rather than starting its own threads, so that many
+  // nodes in one process can share a thread pool.  'crux_asio_service' carries all network I/O and
+  // connection state and 'asio_service' is the worker pool for requests and crypto.  Both must
+  // outlive the node, and the node must not be destroyed from one of their threads.
+  RoutingNode(BoostAsioService& crux_asio_service, AsioService& asio_service,
+              RoutingConfig config = RoutingConfig());
   RoutingNode(const RoutingNode&) = delete;
   RoutingNode(RoutingNode&&) = delete;
   RoutingNode& operator=(const RoutingNode&) = delete;
@@ -93,17 +148,31 @@ class RoutingNode {
     crux_asio_service_.service().post([=]() { connection_manager_.Shutdown(); });
   }
 
+  const Counters& GetCounters() const { return counters_; }
+
+ protected:
+  // Where each message from a peer arrives; tests may call it to deliver messages directly.
+  virtual void MessageReceived(Address peer_id, SerialisedMessage serialised_message);
+
  private:
+  RoutingNode(BoostAsioService* crux_asio_service, AsioService* asio_service,
+              RoutingConfig config);
+
   void HandleMessage(Connect connect, MessageHeader original_header);
   // like connect but add targets endpoint
-  void HandleMessage(ConnectResponse connect_response);
-  // sent by routing nodes to a network Address
-  void HandleMessage(FindGroup find_group, MessageHeader original_header);
+  void HandleMessage(ConnectResponse connect_response, MessageHeader original_header);
+  // sent by routing nodes to a network Address; answered via 'from_peer', the peer it arrived from
+  void HandleMessage(FindGroup find_group, MessageHeader original_header, Address from_peer);
   // each member of the group close to network Address fills in their node_info and replies
   void HandleMessage(FindGroupResponse find_group_reponse, MessageHeader original_header);
+  // each member of a group we asked sends its members' keys, for Sentinel to validate the group's
+  // messages with
+  void HandleMessage(GetGroupKeyResponse get_group_key_response, MessageHeader original_header);
   // may be directly sent to a network Address
   void HandleMessage(GetData get_data, MessageHeader original_header);
-  // Each node wiht the data sends it back to the originator
+  // Each node wiht the data sends it back to the originator; acted on once Sentinel has
+  // validated a quorum of them
+  void HandleMessage(GetDataResponse get_data_response, MessageHeader original_header);
   void HandleMessage(GetDataResponse get_data_response) {
     static_cast<Child*>(this)->HandleGetDataResponse(get_data_response);
   }
@@ -116,11 +185,56 @@ class RoutingNode {
   // each member of a group needs to send this to the network Address (recieveing needs a Quorum)
   // filling in public key again.
   void HandleMessage(routing::Post post, MessageHeader original_header);
+  // message types the routing layer doesn't handle itself (yet)
+  template <typename Message>
+  void HandleMessage(Message /* message */, MessageHeader /* original_header */) {}
+
+  // The received message and its header, passed through the stages of handling it.
+  struct Dispatch {
+    const Address& peer_id;
+    const SerialisedMessage& serialised_message;
+    InputVectorStream& body;
+    MessageHeader header;
+    MessageTypeTag tag;
+  };
+
+  // Hooks run on each parsed message before it is forwarded or handled.  Returning false drops it.
+  template <typename Message>
+  bool PreHandle(Message& /* message */, const Dispatch& /* dispatch */) {
+    return true;
+  }
+  bool PreHandle(GetData& get_data, const Dispatch& dispatch);
+  bool PreHandle(GetDataResponse& get_data_response, const Dispatch& dispatch);
+
+  // Passes a message for us on to its HandleMessage, along with the peer it arrived from where the
+  // handler replies to that peer.
+  template <typename Message>
+  void Handle(Message message, Dispatch& dispatch) {
+    HandleMessage(std::move(message), std::move(dispatch.header));
+  }
+  void Handle(FindGroup find_group, Dispatch& dispatch) {
+    HandleMessage(std::move(find_group), std::move(dispatch.header), dispatch.peer_id);
+  }
+
+  using MessageDispatcher = void (RoutingNode::*)(Dispatch&);
+  template <typename Message>
+  struct DispatchEntry {
+    static MessageDispatcher value() { return &RoutingNode::OnMessage<Message>; }
+  };
+  // Parses the body exactly once, then runs the pre-handle hooks, forwards and handles it.
+  template <typename Message>
+  void OnMessage(Dispatch& dispatch);
+  // sends the message on towards its destination
+  void Forward(Dispatch& dispatch);
+  // true if we are (one of) the message's recipients
+  bool ForUs(const MessageHeader& header) const;
+
   bool TryCache(MessageTypeTag tag, MessageHeader header, Address name);
   Authority OurAuthority(const Address& element, const MessageHeader& header) const;
-  virtual void MessageReceived(Address peer_id, SerialisedMessage serialised_message);
   // virtual void ConnectionLost(Address peer) override final;
   void OnCloseGroupChanged(CloseGroupDifference close_group_difference);
+  // asks 'group' for its members' public keys, for Sentinel to verify its messages with
+  void RequestGroupKey(GroupAddress group);
   SourceAddress OurSourceAddress() const;
   SourceAddress OurSourceAddress(GroupAddress) const;
 
@@ -135,45 +249,160 @@ class RoutingNode {
   // this innocuous looking call will bootstrap the node and also be used if we spot close group
   // nodes appering or vanishing so its pretty important.
   void ConnectToCloseGroup();
+  // asks for the close group of 'target', sending towards 'destination'
+  void SendFindGroup(const Address& destination, const Address& target);
+  // (re)starts the current lookup round's timeout
+  void StartLookupRoundTimer();
+  // records and discards the lookup once it has finished
+  void CheckGroupLookupDone();
+  void ScheduleBucketRefresh();
+  void ScheduleRepublish();
+  // sends our PublicPmid to the group at our address, which caches it for others to fetch
+  void RepublishOurKey();
+  // lets a republish which is nearly due go out alongside a message we are sending to our group
+  void SendingToOurGroup();
+  void RecordHops(boost::optional<HopLimit> hops_remaining);
+  // Bounds how far and for how long a message we send may travel: our hop limit, and a deadline
+  // RoutingConfig::request_timeout from now, after which nodes drop it unhandled.
+  void SetLimits(MessageHeader& header) const;
+  // Passes a message for us to Sentinel, and acts on any message that resolves.
+  void AddToSentinel(MessageHeader header, MessageTypeTag tag, SerialisedMessage body);
+  void HandleValidated(Sentinel::ResultType validated);
+  // copies 'response' back to each requester whose GetData we held behind the one it answers
+  void AnswerCoalescedRequests(const GetDataResponse& response, const MessageHeader& header);
+  // sends on GetData requests we held for longer than their response took to arrive
+  void ScheduleCoalescerSweep();
+  // sends our request 'message_id' towards 'destination' if the congestion window towards the
+  // group holding it allows, else holds it until a response frees space
+  void SendWithinWindow(const Address& destination, MessageId message_id,
+                        SerialisedMessage message);
+  void SendTowards(const Address& destination, SerialisedMessage message);
+  // treats requests left unanswered as lost, sending any this lets through
+  void ScheduleCongestionSweep();
+  // Signs 'serialised' on the worker pool, keeping signing off the network thread, then invokes
+  // 'on_signed(asymm::Signature)' back on the crux thread unless we have been destroyed meanwhile.
+  template <typename Handler>
+  void SignAsync(SerialisedMessage serialised, Handler on_signed);
+  void SendFindGroupResponse(const Address& target, std::vector<passport::PublicPmid> group,
+                             asymm::Signature signature, const MessageHeader& original_header,
+                             const Address& from_peer);
   Address OurId() const { return Address(our_fob_.name()); }
 
  private:
   using unique_identifier = std::pair<Address, uint32_t>;
-  BoostAsioService crux_asio_service_;
-  AsioService asio_service_;
+  // only set where the node runs its own threads
+  const RoutingConfig config_;
+  std::unique_ptr<BoostAsioService> owned_crux_asio_service_;
+  std::unique_ptr<AsioService> owned_asio_service_;
+  BoostAsioService& crux_asio_service_;
+  AsioService& asio_service_;
   passport::Pmid our_fob_;
+  // signs with our_fob_'s key; shared with signing work in flight on the worker pool
+  const std::shared_ptr<const Signer> signer_;
   std::atomic<MessageId> message_id_;
   boost::optional<Address> bootstrap_node_;
   // This crashes for me (PeterJ) on linux.
   // BootstrapHandler bootstrap_handler_;
   ConnectionManager connection_manager_;
   LruCache<unique_identifier, void> filter_;
+  SeenFrom seen_from_;
   Sentinel sentinel_;
-  LruCache<Identity, SerialisedMessage> cache_;
+  GroupKeyPrefetcher group_key_prefetcher_;
+  // the lookup of our close group in progress, if any; only used on the crux thread
+  std::unique_ptr<GroupLookup> group_lookup_;
+  boost::asio::steady_timer group_lookup_timer_;
+  BucketRefreshScheduler bucket_refresh_scheduler_;
+  boost::asio::steady_timer bucket_refresh_timer_;
+  RepublishScheduler republish_scheduler_;
+  boost::asio::steady_timer republish_timer_;
+  RequestCoalescer request_coalescer_;
+  boost::asio::steady_timer request_coalescer_timer_;
+  // only used on the crux thread
+  CongestionWindows congestion_windows_;
+  // the leading bits our close group shares with us, so roughly any group's, keying the windows
+  int close_group_leading_bits_;
+  boost::asio::steady_timer congestion_timer_;
+  LruCache<Identity, EncodedPayload> cache_;
+  LruCache<Data::NameAndTypeId, maidsafe_error> negative_cache_;
   std::vector<Address> connected_nodes_;
+  FindGroupResponseCache find_group_responses_;
+  Counters counters_;
+  std::shared_ptr<boost::none_t> destroy_indicator_;
 };
 
 template <typename Child>
 RoutingNode<Child>::RoutingNode()
-    : crux_asio_service_(1),
-      asio_service_(4),
+    : RoutingNode(nullptr, nullptr, RoutingConfig()) {}
+
+template <typename Child>
+RoutingNode<Child>::RoutingNode(RoutingConfig config)
+    : RoutingNode(nullptr, nullptr, std::move(config)) {}
+
+template <typename Child>
+RoutingNode<Child>::RoutingNode(BoostAsioService& crux_asio_service, AsioService& asio_service,
+                                RoutingConfig config)
+    : RoutingNode(&crux_asio_service, &asio_service, std::move(config)) {}
+
+template <typename Child>
+RoutingNode<Child>::RoutingNode(BoostAsioService* crux_asio_service, AsioService* asio_service,
+                                RoutingConfig config)
+    : config_((config.Validate(), std::move(config))),
+      owned_crux_asio_service_(
+          crux_asio_service ? nullptr : new BoostAsioService(config_.crux_thread_count)),
+      owned_asio_service_(asio_service ? nullptr : new AsioService(config_.worker_thread_count)),
+      crux_asio_service_(crux_asio_service ? *crux_asio_service : *owned_crux_asio_service_),
+      asio_service_(asio_service ? *asio_service : *owned_asio_service_),
       our_fob_(passport::Pmid(passport::Anpmid())),
+      signer_(MakeRsaSigner(our_fob_.private_key())),
       message_id_(RandomUint32()),
       bootstrap_node_(boost::none),
       // bootstrap_handler_(),
-      connection_manager_(crux_asio_service_.service(), passport::PublicPmid(our_fob_)),
-      filter_(std::chrono::minutes(20)),
-      sentinel_([](Address) {}, [](GroupAddress) {}),
-      cache_(std::chrono::minutes(60)),
-      connected_nodes_() {
+      connection_manager_(crux_asio_service_.service(), passport::PublicPmid(our_fob_), config_),
+      filter_(config_.filter_time_to_live),
+      seen_from_(),
+      sentinel_([](Address) {}, [=](GroupAddress group) { RequestGroupKey(std::move(group)); },
+                config_.sentinel_time_to_live),
+      group_key_prefetcher_([=](GroupAddress group) { RequestGroupKey(std::move(group)); }),
+      group_lookup_(),
+      group_lookup_timer_(crux_asio_service_.service()),
+      bucket_refresh_scheduler_(OurId(), [=](const Address& target) {
+        ++counters_.bucket_refreshes;
+        SendFindGroup(target, target);
+      }),
+      bucket_refresh_timer_(crux_asio_service_.service()),
+      republish_scheduler_([=] { RepublishOurKey(); }, config_.key_republish_interval),
+      republish_timer_(crux_asio_service_.service()),
+      request_coalescer_(),
+      request_coalescer_timer_(crux_asio_service_.service()),
+      congestion_windows_(),
+      close_group_leading_bits_(0),
+      congestion_timer_(crux_asio_service_.service()),
+      cache_(config_.cache_time_to_live),
+      negative_cache_(config_.negative_cache_time_to_live),
+      connected_nodes_(),
+      find_group_responses_(),
+      counters_(),
+      destroy_indicator_(new boost::none_t()) {
   // store this to allow other nodes to get our ID on startup. IF they have full routing tables they
   // need Quorum number of these signed anyway.
-  cache_.Add(our_fob_.name(), Serialise(passport::PublicPmid(our_fob_)));
+  cache_.Add(our_fob_.name(),
+             EncodedPayload{PayloadEncoding::kNone, Serialise(passport::PublicPmid(our_fob_))});
   // try an connect to any local nodes (5483) Expect to be told Node_Id
   auto temp_id(MakeIdentity());
 
-  connection_manager_.SetOnConnectionAdded(
-      [=](Address addr) { static_cast<Child*>(this)->HandleConnectionAdded(addr); });
+  connection_manager_.SetOnConnectionAdded([=](Address addr) {
+    // Until our close group is full, each new peer may know nodes closer to us than we have.
+    if (connection_manager_.Size() < GroupSize)
+      ConnectToCloseGroup();
+    static_cast<Child*>(this)->HandleConnectionAdded(addr);
+  });
+  connection_manager_.SetOnCloseGroupChanged([=](CloseGroupDifference close_group_difference) {
+    OnCloseGroupChanged(std::move(close_group_difference));
+  });
+  ScheduleBucketRefresh();
+  ScheduleRepublish();
+  ScheduleCoalescerSweep();
+  ScheduleCongestionSweep();
 
   // PeterJ: Start listening on ports 5483 and 5433 (why two though?)
   // rudp_.Add(rudp::Contact(temp_id, EndpointPair{rudp::Endpoint{GetLocalIp(), 5483},
@@ -203,7 +432,24 @@ RoutingNode<Child>::RoutingNode()
 
 template <typename Child>
 RoutingNode<Child>::~RoutingNode() {
-  crux_asio_service_.Stop();
+  if (owned_crux_asio_service_) {
+    owned_crux_asio_service_->Stop();
+    return;
+  }
+  // The service carries on running other nodes, so just close our connections (cancelling their
+  // pending handlers) on its thread and wait for that before our members are destroyed.
+  std::promise<void> shut_down;
+  crux_asio_service_.service().post([&] {
+    group_lookup_timer_.cancel();
+    bucket_refresh_timer_.cancel();
+    republish_timer_.cancel();
+    request_coalescer_timer_.cancel();
+    congestion_timer_.cancel();
+    connection_manager_.Shutdown();
+    destroy_indicator_.reset();
+    shut_down.set_value();
+  });
+  shut_down.get_future().wait();
 }
 
 template <typename Child>
@@ -212,14 +458,25 @@ GetReturn<CompletionToken> RoutingNode<Child>::Get(Data::NameAndTypeId name_and_
                                                    CompletionToken token) {
   GetHandler<CompletionToken> handler(std::forward<decltype(token)>(token));
   asio::async_result<decltype(handler)> result(handler);
-  asio::post(asio_service_.service(), [=] {
+  // The request is built and sent on the crux thread, which owns the state it reads (the
+  // congestion windows included) and which runs our shutdown, so the guard can't be released
+  // while it runs.
+  std::weak_ptr<boost::none_t> destroy_guard(destroy_indicator_);
+  crux_asio_service_.service().post([=] {
+    if (!destroy_guard.lock())
+      return;
+    // data its group has recently agreed is missing isn't asked for again until that is forgotten
+    if (negative_cache_.Get(name_and_type_id) && !cache_.Get(name_and_type_id.name)) {
+      ++counters_.get_data_misses_answered;
+      return;
+    }
+    const MessageId message_id(++message_id_);
     MessageHeader our_header(std::make_pair(Destination(name_and_type_id.name), boost::none),
-                             OurSourceAddress(), ++message_id_, Authority::node);
+                             OurSourceAddress(), message_id, Authority::node);
+    SetLimits(our_header);
     GetData request(name_and_type_id, OurSourceAddress());
-    auto message(Serialise(our_header, MessageToTag<GetData>::value(), request));
-    for (const auto& target : connection_manager_.GetTarget(name_and_type_id.name)) {
-      connection_manager_.FindPeer(target)->Send(message, [](asio::error_code) {});
-    }
+    SendWithinWindow(name_and_type_id.name, message_id,
+                     Serialise(our_header, MessageToTag<GetData>::value(), request));
   });
   return result.get();
 }
@@ -234,16 +491,31 @@ PutReturn<CompletionToken> RoutingNode<Child>::Put(Address to, DataType data,
                                                    CompletionToken token) {
   PutHandler<CompletionToken> handler(std::forward<decltype(token)>(token));
   asio::async_result<decltype(handler)> result(handler);
-  asio::post(asio_service_.service(), [=] {
-    MessageHeader our_header(std::make_pair(Destination(to), boost::none), OurSourceAddress(),
-                             ++message_id_, Authority::client);
-    PutData request(DataType::Tag::kValue, data.serialise());
-    // FIXME(dirvine) For client in real put this needs signed :08/02/2015
-    // fixme data should serialise properly and not require the above call to serialse()
-    auto message(Serialise(our_header, MessageToTag<PutData>::value(), request));
-    for (const auto& target : connection_manager_.GetTarget(to)) {
-      connection_manager_.FindPeer(target)->Send(message, [](asio::error_code) {});
-    }
+  // As in SignAsync, the worker only touches copies, and anything of ours is left to the crux
+  // thread once the guard shows we still exist.
+  auto& crux_service(crux_asio_service_.service());
+  std::weak_ptr<boost::none_t> destroy_guard(destroy_indicator_);
+  const auto compress_payload_bytes(config_.compress_payload_bytes);
+  asio::post(asio_service_.service(), [=, &crux_service] {
+    auto payload(std::make_shared<SerialisedData>(data.serialise()));
+    // Any node able to parse the message shares our wire version, so can decode the payload
+    // wherever it ends up; there's no need to ask the nodes on the way.
+    const auto encoding(EncodePayload(*payload, compress_payload_bytes));
+    crux_service.post([=] {
+      if (!destroy_guard.lock())
+        return;
+      MessageHeader our_header(std::make_pair(Destination(to), boost::none), OurSourceAddress(),
+                               ++message_id_, Authority::client);
+      SetLimits(our_header);
+      const auto targets(connection_manager_.GetTarget(to));
+      PutData request(DataType::Tag::kValue, std::move(*payload), encoding);
+      // FIXME(dirvine) For client in real put this needs signed :08/02/2015
+      // fixme data should serialise properly and not require the above call to serialse()
+      auto message(Serialise(our_header, MessageToTag<PutData>::value(), request));
+      for (const auto& target : targets) {
+        connection_manager_.FindPeer(target)->Send(message, [](asio::error_code) {});
+      }
+    });
   });
   return result.get();
 }
@@ -254,9 +526,14 @@ PostReturn<CompletionToken> RoutingNode<Child>::Post(Address to, FunctorType fun
                                                      CompletionToken token) {
   PostHandler<CompletionToken> handler(std::forward<decltype(token)>(token));
   asio::async_result<decltype(handler)> result(handler);
-  asio::post(asio_service_.service(), [=] {
+  // sent from the crux thread, which owns the connections; see Get
+  std::weak_ptr<boost::none_t> destroy_guard(destroy_indicator_);
+  crux_asio_service_.service().post([=] {
+    if (!destroy_guard.lock())
+      return;
     MessageHeader our_header(std::make_pair(Destination(to), boost::none), OurSourceAddress(),
                              ++message_id_, Authority::node);
+    SetLimits(our_header);
     PutData request(FunctorType::Tag::kValue, functor);
     // FIXME(dirvine) This needs signed :08/02/2015
     auto message(Serialise(our_header, MessageToTag<routing::Post>::value(), request));
@@ -271,37 +548,206 @@ PostReturn<CompletionToken> RoutingNode<Child>::Post(Address to, FunctorType fun
 
 template <typename Child>
 void RoutingNode<Child>::ConnectToCloseGroup() {
-  FindGroup message(NodeAddress(OurId()), OurId());
-  MessageHeader header(DestinationAddress(std::make_pair(Destination(OurId()), boost::none)),
-                       SourceAddress{OurSourceAddress()}, ++message_id_, Authority::node);
-  if (bootstrap_node_) {
-    auto peer = connection_manager_.FindPeer(*bootstrap_node_);
-    peer->Send(Serialise(header, MessageToTag<FindGroup>::value(), message),
-               [](asio::error_code error) {
-      if (error) {
-        LOG(kWarning) << "rudp cannot send via bootstrap node" << error.message();
-      }
-    });
+  if (group_lookup_)
     return;
+  std::vector<Address> seeds;
+  for (const auto& node : connection_manager_.OurCloseGroup())
+    seeds.emplace_back(node.Name());
+  if (bootstrap_node_)
+    seeds.push_back(*bootstrap_node_);
+  group_lookup_.reset(
+      new GroupLookup(OurId(), seeds, [=](const Address& node) {
+        SendFindGroup(node, OurId());
+        StartLookupRoundTimer();
+      }));
+  group_lookup_->Start();
+  CheckGroupLookupDone();
+}
+
+template <typename Child>
+void RoutingNode<Child>::SendFindGroup(const Address& destination, const Address& target) {
+  if (target == OurId())
+    SendingToOurGroup();
+  FindGroup message(NodeAddress(OurId()), target);
+  MessageHeader header(DestinationAddress(std::make_pair(Destination(destination), boost::none)),
+                       SourceAddress{OurSourceAddress()}, ++message_id_, Authority::node);
+  SetLimits(header);
+  auto serialised(Serialise(header, MessageToTag<FindGroup>::value(), message));
+  auto send_handler([](asio::error_code error) {
+    if (error)
+      LOG(kWarning) << "cannot send FindGroup " << error.message();
+  });
+  // Nodes we are connected to (including the bootstrap node) are asked directly.
+  if (auto peer = connection_manager_.FindPeer(destination)) {
+    peer->Send(serialised, send_handler);
+  } else {
+    for (const auto& node : connection_manager_.GetTarget(destination))
+      connection_manager_.FindPeer(node)->Send(serialised, send_handler);
   }
-  for (const auto& target : connection_manager_.GetTarget(OurId())) {
-    auto peer = connection_manager_.FindPeer(target);
-    peer->Send(Serialise(header, MessageToTag<Connect>::value(), message),
-               [](asio::error_code error) {
-      if (error) {
-        LOG(kWarning) << "rudp cannot send" << error.message();
+}
+
+template <typename Child>
+void RoutingNode<Child>::StartLookupRoundTimer() {
+  // Setting the expiry cancels any wait already pending, so each round is timed from its last send.
+  group_lookup_timer_.expires_from_now(config_.lookup_round_timeout);
+  group_lookup_timer_.async_wait([=](const boost::system::error_code& error) {
+    if (error == boost::asio::error::operation_aborted || !group_lookup_)
+      return;
+    group_lookup_->HandleRoundTimeout();
+    CheckGroupLookupDone();
+  });
+}
+
+template <typename Child>
+void RoutingNode<Child>::CheckGroupLookupDone() {
+  if (!group_lookup_ || !group_lookup_->Done())
+    return;
+  counters_.join_lookup_rounds = group_lookup_->Rounds();
+  counters_.join_lookup_messages = group_lookup_->MessagesSent();
+  group_lookup_timer_.cancel();
+  group_lookup_.reset();
+}
+
+template <typename Child>
+void RoutingNode<Child>::ScheduleBucketRefresh() {
+  bucket_refresh_timer_.expires_from_now(config_.bucket_refresh_interval);
+  bucket_refresh_timer_.async_wait([=](const boost::system::error_code& error) {
+    if (error == boost::asio::error::operation_aborted)
+      return;
+    bucket_refresh_scheduler_.Tick(connection_manager_.Peers());
+    ScheduleBucketRefresh();
+  });
+}
+
+template <typename Child>
+void RoutingNode<Child>::ScheduleRepublish() {
+  republish_timer_.expires_at(republish_scheduler_.Due());
+  republish_timer_.async_wait([=](const boost::system::error_code& error) {
+    if (error == boost::asio::error::operation_aborted)
+      return;
+    republish_scheduler_.OnTimer();
+    ScheduleRepublish();
+  });
+}
+
+template <typename Child>
+void RoutingNode<Child>::RepublishOurKey() {
+  passport::PublicPmid our_public_pmid(our_fob_);
+  auto serialised_pmid(Serialise(our_public_pmid));
+  cache_.Add(our_fob_.name(), EncodedPayload{PayloadEncoding::kNone, serialised_pmid});
+  MessageHeader header(std::make_pair(Destination(OurId()), boost::none), OurSourceAddress(),
+                       ++message_id_, Authority::node);
+  SetLimits(header);
+  auto message(Serialise(header, MessageToTag<PutData>::value(),
+                         PutData(passport::PublicPmid::Tag::kValue, std::move(serialised_pmid))));
+  for (const auto& target : connection_manager_.GetTarget(OurId()))
+    connection_manager_.FindPeer(target)->Send(message, [](asio::error_code) {});
+  ++counters_.key_republishes;
+}
+
+template <typename Child>
+void RoutingNode<Child>::SendingToOurGroup() {
+  if (republish_scheduler_.OnTrafficToGroup())
+    ScheduleRepublish();
+}
+
+template <typename Child>
+void RoutingNode<Child>::ScheduleCoalescerSweep() {
+  request_coalescer_timer_.expires_from_now(std::chrono::seconds(1));
+  request_coalescer_timer_.async_wait([=](const boost::system::error_code& error) {
+    if (error == boost::asio::error::operation_aborted)
+      return;
+    for (auto& expired : request_coalescer_.Expire()) {
+      auto request(std::make_shared<const SerialisedMessage>(std::move(expired.second.request)));
+      for (const auto& target : connection_manager_.GetTarget(expired.first.name)) {
+        if (target != expired.second.from_peer)
+          connection_manager_.FindPeer(target)->Send(request, [](asio::error_code) {});
       }
-    });
+      ++counters_.get_data_coalesce_expired;
+    }
+    ScheduleCoalescerSweep();
+  });
+}
+
+template <typename Child>
+void RoutingNode<Child>::SendWithinWindow(const Address& destination, MessageId message_id,
+                                          SerialisedMessage message) {
+  const auto group(CongestionWindows::GroupOf(destination, close_group_leading_bits_));
+  if (congestion_windows_.TrySend(group, message_id))
+    SendTowards(destination, std::move(message));
+  else if (congestion_windows_.Hold(group, message_id, destination, std::move(message)))
+    ++counters_.requests_held;
+  else
+    ++counters_.requests_dropped;
+}
+
+template <typename Child>
+void RoutingNode<Child>::SendTowards(const Address& destination, SerialisedMessage message) {
+  auto shared_message(std::make_shared<const SerialisedMessage>(std::move(message)));
+  for (const auto& target : connection_manager_.GetTarget(destination))
+    connection_manager_.FindPeer(target)->Send(shared_message, [](asio::error_code) {});
+}
+
+template <typename Child>
+void RoutingNode<Child>::ScheduleCongestionSweep() {
+  congestion_timer_.expires_from_now(std::chrono::seconds(1));
+  congestion_timer_.async_wait([=](const boost::system::error_code& error) {
+    if (error == boost::asio::error::operation_aborted)
+      return;
+    for (auto& released : congestion_windows_.Expire())
+      SendTowards(released.first, std::move(released.second));
+    ScheduleCongestionSweep();
+  });
+}
+
+template <typename Child>
+void RoutingNode<Child>::AnswerCoalescedRequests(const GetDataResponse& response,
+                                                 const MessageHeader& header) {
+  auto replies(request_coalescer_.Answer(response.name_and_type_id(), header.FromNode().data));
+  if (replies.empty())
+    return;
+  // The body is unchanged, so the responder's signature over it still holds; only the header is
+  // addressed afresh to each requester.
+  const auto body(Serialise(response));
+  const auto signature(header.Signature());
+  for (const auto& requester : replies) {
+    MessageHeader reply(signature ? MessageHeader(requester.reply_to, header.Source(),
+                                                  requester.message_id, header.FromAuthority(),
+                                                  *signature, header.SignedWith())
+                                  : MessageHeader(requester.reply_to, header.Source(),
+                                                  requester.message_id, header.FromAuthority()));
+    SetLimits(reply);
+    const auto message(SerialiseWithBody(reply, MessageToTag<GetDataResponse>::value(), body));
+    if (auto peer = connection_manager_.FindPeer(requester.from_peer)) {
+      peer->Send(message, [](asio::error_code) {});
+    } else {
+      for (const auto& target : connection_manager_.GetTarget(requester.reply_to.first))
+        connection_manager_.FindPeer(target)->Send(message, [](asio::error_code) {});
+    }
+    ++counters_.get_data_fanned_out;
   }
 }
 
 template <typename Child>
-void RoutingNode<Child>::MessageReceived(Address /* peer_id */,
-                                         SerialisedMessage serialised_message) {
+void RoutingNode<Child>::RecordHops(boost::optional<HopLimit> hops_remaining) {
+  // Only messages sent with the same limit as ours can be measured.
+  if (!hops_remaining || *hops_remaining > config_.hop_limit)
+    return;
+  counters_.hops_total += config_.hop_limit - *hops_remaining + 1;
+  ++counters_.hops_measured;
+}
+
+template <typename Child>
+void RoutingNode<Child>::SetLimits(MessageHeader& header) const {
+  header.SetHopLimit(config_.hop_limit);
+  header.SetDeadline(std::chrono::system_clock::now() + config_.request_timeout);
+}
+
+template <typename Child>
+void RoutingNode<Child>::MessageReceived(Address peer_id, SerialisedMessage serialised_message) {
   InputVectorStream binary_input_stream{serialised_message};
   MessageHeader header;
   MessageTypeTag tag;
-  Identity name;
   try {
     Parse(binary_input_stream, header, tag);
   } catch (const std::exception&) {
@@ -309,90 +755,167 @@ void RoutingNode<Child>::MessageReceived(Address /* peer_id */,
     return;
   }
 
+  // Shed stale traffic before doing any further work on it.
+  if (header.Expired()) {
+    ++counters_.expired_dropped;
+    return;
+  }
+
+  // every peer a message arrives from already holds it, so it is not forwarded to any of them
+  seen_from_.Add(header.FilterValue(), peer_id);
   if (filter_.Check(header.FilterValue()))
     return;  // already seen
   // add to filter as soon as posible
   filter_.Add({header.FilterValue()});
+  bucket_refresh_scheduler_.Touch(peer_id);
 
-  // We add these to cache
-  if (tag == MessageTypeTag::GetDataResponse) {
-    auto data = Parse<GetDataResponse>(binary_input_stream);
-    if (data.data())
-      cache_.Add(data.name_and_type_id().name, *data.data());
+  static const auto dispatch_table(
+      MakeDispatchTable<MessageDispatcher, DispatchEntry>(AllMessages()));
+  Dispatch dispatch{peer_id, serialised_message, binary_input_stream, std::move(header), tag};
+  const auto dispatcher(FindDispatchEntry(dispatch_table, tag));
+  if (!dispatcher) {
+    // still route it on, as peers running a newer version may understand it
+    Forward(dispatch);
+    LOG(kWarning) << "Received message of unknown type.";
+    return;
   }
-  // if we can satisfy request from cache we do
-  if (tag == MessageTypeTag::GetData) {
-    auto data = Parse<GetData>(binary_input_stream);
-    auto test = cache_.Get(data.name_and_type_id().name);
-    // FIXME(dirvine) move to upper lauer :09/02/2015
-    // if (test) {
-    //   GetDataResponse response(data.name(), test);
-    //   auto message(Serialise(MessageHeader(header.Destination(), OurSourceAddress(),
-    //                                        header.MessageId(), Authority::node),
-    //                          MessageTypeTag::GetDataResponse, response));
-    //   for (const auto& target : connection_manager_.GetTarget(header.FromNode()))
-    //     rudp_.Send(target.id, message, [](asio::error_code error) {
-    //       if (error) {
-    //         LOG(kWarning) << "rudp cannot send" << error.message();
-    //       }
-    //     });
-    //   return;
-    // }
+  (this->*dispatcher)(dispatch);
+}
+
+template <typename Child>
+template <typename Message>
+void RoutingNode<Child>::OnMessage(Dispatch& dispatch) {
+  Message message;
+  try {
+    Parse(dispatch.body, message);
+  } catch (const std::exception&) {
+    LOG(kError) << "body failure." << boost::current_exception_diagnostic_information();
+    return;
   }
+  if (!PreHandle(message, dispatch))
+    return;
+  const auto hops_remaining(dispatch.header.HopsRemaining());
+  Forward(dispatch);
+  if (!ForUs(dispatch.header))
+    return;
+  if (dispatch.header.FromGroup())
+    group_key_prefetcher_.Heard(*dispatch.header.FromGroup());
+  RecordHops(hops_remaining);
+  // FIXME(dirvine) Sentinel check here!!  :19/01/2015
+  Handle(std::move(message), dispatch);
+}
 
+template <typename Child>
+void RoutingNode<Child>::Forward(Dispatch& dispatch) {
+  auto& header(dispatch.header);
   // send to next node(s) even our close group (swarm mode)
-  for (const auto& target : connection_manager_.GetTarget(header.Destination().first)) {
+  auto targets(connection_manager_.GetTarget(header.Destination().first));
+  // Sending the message back to peers known to hold it would only see it dropped by their filter
+  // after costing a datagram and a parse.
+  counters_.forwards_suppressed += seen_from_.RemoveHolders(header.FilterValue(), targets);
+  if (targets.empty())
+    return;
+  // Mark the message if our queue to any next hop is backed up, so that its originator slows down.
+  const bool mark(!header.CongestionExperienced() &&
+                  std::any_of(std::begin(targets), std::end(targets), [&](const Address& target) {
+                    const PeerNode* peer = connection_manager_.FindPeer(target);
+                    return peer && peer->PendingSendBytes() >= config_.congested_peer_bytes;
+                  }));
+  const bool rewrite(header.HopsRemaining() || mark);
+  const auto header_size(rewrite ? Serialise(header, dispatch.tag).size() : 0);
+  if (!header.DecrementHopLimit()) {
+    ++counters_.hop_limit_dropped;  // no hops left, but we may still be a recipient
+    return;
+  }
+  if (mark) {
+    header.MarkCongestionExperienced();
+    ++counters_.congestion_marked;
+  }
+  // one copy of the message is shared by every send rather than one copy per target
+  auto forwarded(dispatch.serialised_message);
+  if (rewrite)
+    ReplaceHeader(header, dispatch.tag, header_size, forwarded);
+  auto forwarded_message(std::make_shared<const SerialisedMessage>(std::move(forwarded)));
+  for (const auto& target : targets) {
     PeerNode* peer = connection_manager_.FindPeer(target);
-    peer->Send(serialised_message, [](asio::error_code error) {
+    peer->Send(forwarded_message, [](asio::error_code error) {
       if (error) {
         LOG(kWarning) << "cannot send" << error.message();
       }
     });
   }
+}
+
+template <typename Child>
+bool RoutingNode<Child>::ForUs(const MessageHeader& header) const {
   // FIXME(dirvine) We need new rudp for this :26/01/2015
   if (header.RelayedMessage() &&
       std::any_of(
           std::begin(connected_nodes_), std::end(connected_nodes_),
           [&header](const Address& node) { return node == header.ReplyToAddress()->data; })) {
     // send message to connected node
-    return;
+    return false;
   }
+  return connection_manager_.AddressInCloseGroupRange(header.Destination().first);
+}
+
+template <typename Child>
+bool RoutingNode<Child>::PreHandle(GetData& get_data, const Dispatch& dispatch) {
+  // if we can satisfy request from cache we do
+  auto test = cache_.Get(get_data.name_and_type_id().name);
+  // FIXME(dirvine) move to upper lauer :09/02/2015
+  // if (test) {
+  //   GetDataResponse response(data.name(), test);
+  //   auto message(Serialise(MessageHeader(header.Destination(), OurSourceAddress(),
+  //                                        header.MessageId(), Authority::node),
+  //                          MessageTypeTag::GetDataResponse, response));
+  //   for (const auto& target : connection_manager_.GetTarget(header.FromNode()))
+  //     rudp_.Send(target.id, message, [](asio::error_code error) {
+  //       if (error) {
+  //         LOG(kWarning) << "rudp cannot send" << error.message();
+  //       }
+  //     });
+  //   return;
+  // }
 
-  if (!connection_manager_.AddressInCloseGroupRange(header.Destination().first))
-    return;  // not for us
+  if (ForUs(dispatch.header))
+    return true;
+  // Hold a request for data already being fetched through us instead of sending it on too.  Only
+  // requests from clients we relay for are held, as only their responses are addressed to us and
+  // so certain to pass us.  It is held as it would have been forwarded.
+  if (!dispatch.header.RelayedMessage() || dispatch.header.FromNode().data != OurId())
+    return true;
+  auto header(dispatch.header);
+  if (!header.DecrementHopLimit())
+    return true;  // left for Forward to drop
+  auto request(dispatch.serialised_message);
+  if (header.HopsRemaining())
+    ReplaceHeader(header, dispatch.tag, Serialise(dispatch.header, dispatch.tag).size(), request);
+  if (!request_coalescer_.Join(get_data.name_and_type_id(),
+                               {dispatch.peer_id, header.ReturnDestinationAddress(),
+                                header.MessageId(), std::move(request)}))
+    return true;
+  ++counters_.get_data_coalesced;
+  return false;
+}
 
-  // FIXME(dirvine) Sentinel check here!!  :19/01/2015
-  switch (tag) {
-    case MessageTypeTag::Connect:
-      HandleMessage(Parse<Connect>(binary_input_stream), std::move(header));
-      break;
-    case MessageTypeTag::ConnectResponse:
-      HandleMessage(Parse<ConnectResponse>(binary_input_stream));
-      break;
-    case MessageTypeTag::FindGroup:
-      HandleMessage(Parse<FindGroup>(binary_input_stream), std::move(header));
-      break;
-    case MessageTypeTag::FindGroupResponse:
-      HandleMessage(Parse<FindGroupResponse>(binary_input_stream), std::move(header));
-      break;
-    case MessageTypeTag::GetData:
-      static_cast<Child*>(this)
-          ->HandleMessage(Parse<GetData>(binary_input_stream), std::move(header));
-      break;
-    case MessageTypeTag::GetDataResponse:
-      // static_cast<Child*>(this)
-      //     ->HandleMessage(Parse<GetDataResponse>(binary_input_stream), std::move(header));
-      break;
-    case MessageTypeTag::PutData:
-      HandleMessage(Parse<PutData>(binary_input_stream), std::move(header));
-      break;
-    case MessageTypeTag::Post:
-      HandleMessage(Parse<routing::Post>(binary_input_stream), std::move(header));
-      break;
-    default:
-      LOG(kWarning) << "Received message of unknown type.";
-      break;
+template <typename Child>
+bool RoutingNode<Child>::PreHandle(GetDataResponse& get_data_response,
+                                   const Dispatch& dispatch) {
+  AnswerCoalescedRequests(get_data_response, dispatch.header);
+  // a response to our own request frees its place in the window towards the data's group
+  if (dispatch.header.Destination().first.data == OurId()) {
+    for (auto& released : congestion_windows_.Acknowledge(
+             dispatch.header.MessageId(), dispatch.header.CongestionExperienced()))
+      SendTowards(released.first, std::move(released.second));
+  }
+  // We add these to cache, still encoded, so relays cache compressed payloads too.  The payload is
+  // copied, as the response is still to be handled.
+  if (get_data_response.data()) {
+    cache_.Add(get_data_response.name_and_type_id().name,
+               EncodedPayload{get_data_response.encoding(), *get_data_response.data()});
   }
+  return true;
 }
 
 template <typename Child>
@@ -427,42 +950,44 @@ template <typename Child>
 void RoutingNode<Child>::HandleMessage(Connect connect, MessageHeader original_header) {
   if (!connection_manager_.IsManaged(connect.requester_id()))
     return;
-  auto targets(connection_manager_.GetTarget(connect.requester_id()));
   ConnectResponse respond(connect.requester_endpoints(), NextEndpointPair(), connect.requester_id(),
                           OurId(), passport::PublicPmid(our_fob_));
   assert(connect.receiver_id() == OurId());
 
-  MessageHeader header(DestinationAddress(original_header.ReturnDestinationAddress()),
-                       SourceAddress(OurSourceAddress()), original_header.MessageId(),
-                       Authority::node,
-                       asymm::Sign(asymm::PlainText(Serialise(respond)), our_fob_.private_key()));
-  // FIXME(dirvine) Do we need to pass a shared_from_this type object or this may segfault on
-  // shutdown
-  // :24/01/2015
-  for (auto& target : targets) {
-    connection_manager_.FindPeer(target)
-        ->Send(Serialise(header, MessageToTag<ConnectResponse>::value(), respond),
-               [connect, this](asio::error_code error_code) {
-          if (error_code)
-            return;
-        });
-  }
+  auto serialised_response(Serialise(respond));
+  const auto requester_id(connect.requester_id());
+  SignAsync(serialised_response, [=](asymm::Signature signature) {
+    MessageHeader header(DestinationAddress(original_header.ReturnDestinationAddress()),
+                         SourceAddress(OurSourceAddress()), original_header.MessageId(),
+                         Authority::node, std::move(signature), signer_->Scheme());
+    SetLimits(header);
+    auto message(
+        SerialiseWithBody(header, MessageToTag<ConnectResponse>::value(), serialised_response));
+    for (const auto& target : connection_manager_.GetTarget(requester_id)) {
+      if (auto peer = connection_manager_.FindPeer(target))
+        peer->Send(message, [](asio::error_code) {});
+    }
+  });
 
-  connection_manager_.AddNode(NodeInfo(connect.requester_id(), connect.requester_fob(), true),
-                              connect.requester_endpoints());
+  auto endpoints(connect.requester_endpoints());
+  connection_manager_.AddNode(
+      NodeInfo(connect.requester_id(), std::move(connect).requester_fob(), true),
+      std::move(endpoints));
 
   // if (added)
   //  static_cast<Child*>(this)->HandleChurn(*added);
 }
 
 template <typename Child>
-void RoutingNode<Child>::HandleMessage(ConnectResponse connect_response) {
+void RoutingNode<Child>::HandleMessage(ConnectResponse connect_response,
+                                       MessageHeader /* original_header */) {
   if (!connection_manager_.IsManaged(connect_response.requester_id()))
     return;
 
+  auto endpoints(connect_response.receiver_endpoints());
   connection_manager_.AddNode(
-      NodeInfo(connect_response.requester_id(), connect_response.receiver_fob(), true),
-      connect_response.receiver_endpoints());
+      NodeInfo(connect_response.requester_id(), std::move(connect_response).receiver_fob(), true),
+      std::move(endpoints));
 
   // auto target = connect_response.requester_id();
   // TODO(PeterJ):
@@ -483,40 +1008,137 @@ void RoutingNode<Child>::HandleMessage(ConnectResponse connect_response) {
   //    });
 }
 template <typename Child>
-void RoutingNode<Child>::HandleMessage(FindGroup find_group, MessageHeader original_header) {
+void RoutingNode<Child>::HandleMessage(FindGroup find_group, MessageHeader original_header,
+                                       Address from_peer) {
+  const auto epoch(connection_manager_.CloseGroupEpoch());
+  const auto& target(find_group.target_id());
+  if (const auto* cached = find_group_responses_.Get(target, epoch)) {
+    ++counters_.find_group_signatures_reused;
+    SendFindGroupResponse(target, cached->group, cached->signature, original_header, from_peer);
+    return;
+  }
   auto group = connection_manager_.OurCloseGroup();
   // add ourselves
   group.push_back(passport::PublicPmid(our_fob_));
-  FindGroupResponse response(find_group.target_id(), std::move(group));
+  SignAsync(Serialise(FindGroupResponse(target, group)), [=](asymm::Signature signature) {
+    find_group_responses_.Add(target, epoch, FindGroupResponseCache::Entry{group, signature});
+    SendFindGroupResponse(target, group, signature, original_header, from_peer);
+  });
+}
+
+template <typename Child>
+void RoutingNode<Child>::SendFindGroupResponse(const Address& target,
+                                               std::vector<passport::PublicPmid> group,
+                                               asymm::Signature signature,
+                                               const MessageHeader& original_header,
+                                               const Address& from_peer) {
+  FindGroupResponse response(target, std::move(group));
   MessageHeader header(DestinationAddress(original_header.ReturnDestinationAddress()),
-                       SourceAddress(OurSourceAddress(GroupAddress(find_group.target_id()))),
-                       original_header.MessageId(), Authority::nae_manager,
-                       asymm::Sign(asymm::PlainText(Serialise(response)), our_fob_.private_key()));
+                       SourceAddress(OurSourceAddress(GroupAddress(target))),
+                       original_header.MessageId(), Authority::nae_manager, std::move(signature),
+                       signer_->Scheme());
+  SetLimits(header);
   auto message(Serialise(header, MessageToTag<FindGroupResponse>::value(), response));
-  for (const auto& node : connection_manager_.GetTarget(original_header.FromNode())) {
-    connection_manager_.FindPeer(node)->Send(message, [](asio::error_code) {});
+  // The peer which passed us the request is usually the requester itself, e.g. a joining node
+  // asking its bootstrap contact, so it is answered directly.
+  if (auto peer = connection_manager_.FindPeer(from_peer)) {
+    peer->Send(message, [](asio::error_code) {});
+  } else {
+    for (const auto& node : connection_manager_.GetTarget(original_header.FromNode()))
+      connection_manager_.FindPeer(node)->Send(message, [](asio::error_code) {});
   }
 }
 
+template <typename Child>
+template <typename Handler>
+void RoutingNode<Child>::SignAsync(SerialisedMessage serialised, Handler on_signed) {
+  // Only copies are used on the worker thread, as the node may be destroyed before it runs.
+  auto signer(signer_);
+  auto& crux_service(crux_asio_service_.service());
+  std::weak_ptr<boost::none_t> destroy_guard(destroy_indicator_);
+  asio::post(asio_service_.service(), [=, &crux_service] {
+    auto signature(signer->Sign(serialised));
+    crux_service.post([=] {
+      if (destroy_guard.lock())
+        on_signed(signature);
+    });
+  });
+}
+
 template <typename Child>
 void RoutingNode<Child>::HandleMessage(FindGroupResponse find_group_reponse,
-                                       MessageHeader /* original_header */) {
+                                       MessageHeader original_header) {
   // this is called to get our group on bootstrap, we will try and connect to each of these nodes
   // Only other reason is to allow the sentinel to check signatures and those calls will just fall
   // through here.
-  for (const auto node_pmid : find_group_reponse.group()) {
+  if (group_lookup_ && find_group_reponse.target_id() == group_lookup_->Target()) {
+    std::vector<Address> group;
+    for (const auto& node_pmid : find_group_reponse.group()) {
+      if (Address(node_pmid.Name()) != OurId())
+        group.emplace_back(node_pmid.Name());
+    }
+    group_lookup_->HandleResponse(original_header.FromNode().data, group);
+    CheckGroupLookupDone();
+  }
+  for (const auto& node_pmid : find_group_reponse.group()) {
     Address node_id(node_pmid.Name());
     if (!connection_manager_.IsManaged(node_id))
       continue;
     Connect message(NextEndpointPair(), OurId(), node_id, passport::PublicPmid(our_fob_));
     MessageHeader header(DestinationAddress(std::make_pair(Destination(node_id), boost::none)),
                          SourceAddress{OurSourceAddress()}, ++message_id_, Authority::nae_manager);
+    SetLimits(header);
     for (const auto& target : connection_manager_.GetTarget(node_id))
       connection_manager_.FindPeer(target)->Send(
           Serialise(header, MessageToTag<Connect>::value(), message), [](asio::error_code) {});
   }
 }
 
+template <typename Child>
+void RoutingNode<Child>::HandleMessage(GetGroupKeyResponse get_group_key_response,
+                                       MessageHeader original_header) {
+  // group messages held by Sentinel may be waiting on these keys
+  AddToSentinel(std::move(original_header), MessageToTag<GetGroupKeyResponse>::value(),
+                Serialise(get_group_key_response));
+}
+
+template <typename Child>
+void RoutingNode<Child>::HandleMessage(GetDataResponse get_data_response,
+                                       MessageHeader original_header) {
+  // The body is serialised exactly as its senders signed it.
+  AddToSentinel(std::move(original_header), MessageToTag<GetDataResponse>::value(),
+                Serialise(get_data_response));
+}
+
+template <typename Child>
+void RoutingNode<Child>::AddToSentinel(MessageHeader header, MessageTypeTag tag,
+                                       SerialisedMessage body) {
+  boost::optional<Sentinel::ResultType> validated;
+  try {
+    validated = sentinel_.Add(std::move(header), tag, std::move(body));
+  } catch (const std::exception&) {
+    LOG(kWarning) << "invalid message for Sentinel."
+                  << boost::current_exception_diagnostic_information();
+    return;
+  }
+  if (validated)
+    HandleValidated(std::move(*validated));
+}
+
+template <typename Child>
+void RoutingNode<Child>::HandleValidated(Sentinel::ResultType validated) {
+  if (std::get<1>(validated) != MessageTypeTag::GetDataResponse)
+    return;
+  try {
+    auto response(Parse<GetDataResponse>(std::get<2>(validated)));
+    // A miss a quorum of the data's group agrees on can be relied on for a while.
+    if (response.error())
+      negative_cache_.Add(response.name_and_type_id(), *response.error());
+  } catch (const std::exception&) {
+    LOG(kError) << "validated body failure." << boost::current_exception_diagnostic_information();
+  }
+}
+
 template <typename Child>
 void RoutingNode<Child>::HandleMessage(GetData get_data, MessageHeader header) {
   auto result = static_cast<Child*>(this)->HandleGet(
@@ -534,7 +1156,19 @@ void RoutingNode<Child>::HandleMessage(GetData get_data, MessageHeader header) {
 }
 
 template <typename Child>
-void RoutingNode<Child>::HandleMessage(PutData /*put_data*/, MessageHeader /* original_header */) {}
+void RoutingNode<Child>::HandleMessage(PutData put_data, MessageHeader original_header) {
+  // Forwarding nodes pass the payload on as it is; only the node it is for decodes it.
+  SerialisedData data;
+  try {
+    data = DecodePayload(put_data.encoding(), std::move(put_data).data(),
+                         config_.max_message_size);
+  } catch (const std::exception& e) {
+    LOG(kWarning) << "Cannot decode data payload: " << e.what();
+    return;
+  }
+  // The upper layer stores or refuses the data; no PutDataResponse is sent back yet either way.
+  static_cast<Child*>(this)->HandlePut(original_header.FromNode().data, std::move(data));
+}
 
 template <typename Child>
 void RoutingNode<Child>::HandleMessage(PutDataResponse /*put_data_response*/,
@@ -544,6 +1178,33 @@ template <typename Child>
 void RoutingNode<Child>::HandleMessage(routing::Post /* post */,
                                        MessageHeader /* original_header */) {}
 
+template <typename Child>
+void RoutingNode<Child>::OnCloseGroupChanged(CloseGroupDifference close_group_difference) {
+  const auto& new_group(close_group_difference.first);
+  const int leading_bits(
+      new_group.size() < GroupSize ? 0 : CommonLeadingBits(OurId(), new_group.back()));
+  sentinel_.SetCloseGroupLeadingBits(leading_bits);
+  close_group_leading_bits_ = leading_bits;
+  // Groups we hear from whose membership may have changed too will soon sign with keys we don't
+  // hold, so fetch their keys ahead of their messages.
+  group_key_prefetcher_.Prefetch(
+      group_key_prefetcher_.GroupsToPrefetch(close_group_difference, leading_bits));
+  static_cast<Child*>(this)->HandleChurn(std::move(close_group_difference));
+}
+
+template <typename Child>
+void RoutingNode<Child>::RequestGroupKey(GroupAddress group) {
+  if (group.data == OurId())
+    SendingToOurGroup();
+  MessageHeader header(std::make_pair(Destination(group.data), boost::none), OurSourceAddress(),
+                       ++message_id_, Authority::node);
+  SetLimits(header);
+  auto message(Serialise(header, MessageToTag<GetGroupKey>::value(),
+                         GetGroupKey(OurSourceAddress(), group.data)));
+  for (const auto& target : connection_manager_.GetTarget(group.data))
+    connection_manager_.FindPeer(target)->Send(message, [](asio::error_code) {});
+}
+
 template <typename Child>
 SourceAddress RoutingNode<Child>::OurSourceAddress() const {
   if (bootstrap_node_)
@@ -47,6 +47,11 @@ namespace routing {
 
 static const size_t GroupSize = 23;
 static const size_t QuorumSize = 19;
+// Hops a message originated by us may take before being dropped; far above the expected O(log n).
+static const uint8_t DefaultHopLimit = 64;
+static const size_t DefaultMaxMessageSize = 1048576;
+// Receive buffer for the fob exchanged when a connection is made.
+static const size_t DefaultExchangeBufferSize = 262144;
 
 enum class FromType : int32_t {
   client_manager,
@@ -69,6 +74,7 @@ enum class Authority : int32_t {
 
 using Address = Identity;
 using MessageId = uint32_t;
+using HopLimit = uint8_t;
 using Destination = TaggedValue<Address, struct DestinationTag>;
 using ReplyToAddress = TaggedValue<Address, struct ReplytoTag>;
 using DestinationAddress = std::pair<Destination, boost::optional<ReplyToAddress>>;
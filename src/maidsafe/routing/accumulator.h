@@ -65,6 +65,7 @@ class Accumulator {
 
   // returns true when the quorum has been reached. This will return Quorum times
   // a tuple of valuetype which should be Source Address signature tag type and value
+  // A sender adding again replaces its earlier value, e.g. a fresher list of keys.
   boost::optional<std::pair<NameType, Map>> Add(const NameType& name, ValueType value,
                                                 Address sender) {
     auto it = storage_.find(name);
@@ -73,7 +74,12 @@ class Accumulator {
       it = storage_.find(name);
     }
 
-    std::get<0>(it->second).insert(std::make_pair(std::move(sender), std::move(value)));
+    auto& parts(std::get<0>(it->second));
+    auto part(parts.find(sender));
+    if (part == std::end(parts))
+      parts.insert(std::make_pair(std::move(sender), std::move(value)));
+    else
+      part->second = std::move(value);
     ReOrder(name);
     if (std::get<0>(it->second).size() >= quorum_)
       return std::make_pair(it->first, std::get<0>(it->second));
@@ -102,6 +108,14 @@ class Accumulator {
 
   size_t size() const { return storage_.size(); }
 
+  // Parts held across all names, which is what an attacker inflates by spraying unique names.
+  size_t parts() const {
+    size_t count(0);
+    for (const auto& entry : storage_)
+      count += std::get<0>(entry.second).size();
+    return count;
+  }
+
  private:
   void AddNew(NameType name, ValueType value, Address sender) {
     // check if we have entries with time expired
@@ -30,10 +30,8 @@ namespace maidsafe {
 namespace routing {
 
 template <class Handler /* void(boost::system::error_code, SerialisedMessage) */>
-void AsyncExchange(crux::socket& socket, SerialisedMessage our_data, Handler handler) {
-  // TODO(Team): Use some predefined constant for buffer size.
-  static const std::size_t max_buffer_size = 262144;
-
+void AsyncExchange(crux::socket& socket, SerialisedMessage our_data, Handler handler,
+                   std::size_t max_buffer_size = DefaultExchangeBufferSize) {
   struct State {
     boost::optional<boost::system::error_code> first_error;
     SerialisedMessage rx_buffer;
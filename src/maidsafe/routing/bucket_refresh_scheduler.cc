@@ -0,0 +1,131 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/bucket_refresh_scheduler.h"
+
+#include <algorithm>
+#include <cassert>
+#include <string>
+#include <utility>
+
+#include "maidsafe/common/utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+BucketRefreshScheduler::BucketRefreshScheduler(Address our_id, Lookup lookup,
+                                               Clock::duration idle_period,
+                                               Clock::duration retry_interval,
+                                               std::size_t min_occupancy,
+                                               std::size_t max_lookups_per_tick,
+                                               Clock::time_point now)
+    : our_id_(std::move(our_id)),
+      lookup_(std::move(lookup)),
+      idle_period_(idle_period),
+      retry_interval_(retry_interval),
+      min_occupancy_(min_occupancy),
+      max_lookups_per_tick_(max_lookups_per_tick),
+      started_(now),
+      last_heard_(),
+      last_looked_up_(),
+      lookups_sent_(0) {}
+
+void BucketRefreshScheduler::Touch(const Address& node, Clock::time_point now) {
+  if (node == our_id_)
+    return;
+  auto& last_heard(last_heard_[CommonLeadingBits(our_id_, node)]);
+  last_heard = std::max(last_heard, now);
+}
+
+std::vector<int> BucketRefreshScheduler::Tick(const std::vector<Address>& contacts,
+                                              Clock::time_point now) {
+  std::map<int, std::size_t> occupancy;
+  int close_bucket(0);
+  {
+    // the bucket of the furthest member of our close group (or of our furthest contact)
+    std::vector<int> buckets;
+    buckets.reserve(contacts.size());
+    for (const auto& contact : contacts) {
+      if (contact == our_id_)
+        continue;
+      buckets.push_back(CommonLeadingBits(our_id_, contact));
+      ++occupancy[buckets.back()];
+    }
+    if (buckets.empty())
+      return {};
+    const auto group_end(std::begin(buckets) + std::min(buckets.size(), GroupSize) - 1);
+    std::nth_element(std::begin(buckets), group_end, std::end(buckets), std::greater<int>());
+    close_bucket = *group_end;
+  }
+
+  std::vector<int> underpopulated, idle;
+  std::vector<std::pair<Clock::time_point, int>> idle_since;
+  for (int bucket(0); bucket < close_bucket; ++bucket) {
+    auto looked_up(last_looked_up_.find(bucket));
+    if (looked_up != std::end(last_looked_up_) && now - looked_up->second < retry_interval_)
+      continue;
+    if (occupancy[bucket] < min_occupancy_) {
+      underpopulated.push_back(bucket);
+      continue;
+    }
+    auto heard(last_heard_.find(bucket));
+    auto last_active(heard == std::end(last_heard_) ? started_ : heard->second);
+    if (looked_up != std::end(last_looked_up_))
+      last_active = std::max(last_active, looked_up->second);
+    if (now - last_active >= idle_period_)
+      idle_since.emplace_back(last_active, bucket);
+  }
+  // longest idle first
+  std::sort(std::begin(idle_since), std::end(idle_since));
+  for (const auto& bucket : idle_since)
+    idle.push_back(bucket.second);
+
+  std::vector<int> looked_up;
+  for (const auto& stale : {std::cref(underpopulated), std::cref(idle)}) {
+    for (auto bucket : stale.get()) {
+      if (looked_up.size() == max_lookups_per_tick_)
+        return looked_up;
+      last_looked_up_[bucket] = now;
+      looked_up.push_back(bucket);
+      ++lookups_sent_;
+      lookup_(RandomAddressInBucket(our_id_, bucket));
+    }
+  }
+  return looked_up;
+}
+
+Address BucketRefreshScheduler::RandomAddressInBucket(const Address& our_id, int bucket) {
+  assert(bucket >= 0 && bucket < static_cast<int>(Address::kSize * 8));
+  const auto ours(our_id.string());
+  auto result(RandomString(Address::kSize));
+  const auto byte(static_cast<std::size_t>(bucket / 8));
+  std::copy(std::begin(ours), std::begin(ours) + byte, std::begin(result));
+  // within the byte holding bit 'bucket': our bits before it, that bit flipped, random bits after
+  const auto flip(static_cast<unsigned char>(0x80 >> (bucket % 8)));
+  const auto prefix(static_cast<unsigned char>(~((flip << 1) - 1)));
+  const auto our_byte(static_cast<unsigned char>(ours[byte]));
+  const auto random_byte(static_cast<unsigned char>(result[byte]));
+  result[byte] = static_cast<char>((our_byte & prefix) | (~our_byte & flip) |
+                                   (random_byte & (flip - 1)));
+  return Address(result);
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
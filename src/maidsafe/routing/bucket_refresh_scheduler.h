@@ -0,0 +1,85 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_BUCKET_REFRESH_SCHEDULER_H_
+#define MAIDSAFE_ROUTING_BUCKET_REFRESH_SCHEDULER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <vector>
+
+#include "maidsafe/routing/routing_table.h"
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Keeps the buckets beyond our close group populated with live contacts, so that routing stays at
+// O(log n) hops under churn.  A bucket (a value of 'BucketIndex') is stale if it holds fewer than
+// 'min_occupancy' contacts, or if nothing has been heard from it for 'idle_period'.  Each Tick()
+// looks up a random address in up to 'max_lookups_per_tick' stale buckets, underpopulated ones
+// first, and a bucket looked up is not looked up again for 'retry_interval'.  Buckets at or beyond
+// the furthest member of our close group are left to close group maintenance.  Not thread-safe.
+class BucketRefreshScheduler {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using Lookup = std::function<void(const Address& target)>;
+
+  BucketRefreshScheduler(Address our_id, Lookup lookup,
+                         Clock::duration idle_period = std::chrono::minutes(15),
+                         Clock::duration retry_interval = std::chrono::minutes(1),
+                         std::size_t min_occupancy = 2,
+                         std::size_t max_lookups_per_tick = RoutingTable::Parallelism(),
+                         Clock::time_point now = Clock::now());
+  BucketRefreshScheduler(const BucketRefreshScheduler&) = delete;
+  BucketRefreshScheduler(BucketRefreshScheduler&&) = delete;
+  ~BucketRefreshScheduler() = default;
+  BucketRefreshScheduler& operator=(const BucketRefreshScheduler&) = delete;
+  BucketRefreshScheduler& operator=(BucketRefreshScheduler&&) = delete;
+
+  // Records that 'node' has been heard from, which keeps its bucket fresh.
+  void Touch(const Address& node, Clock::time_point now = Clock::now());
+  // Looks up stale buckets given our current 'contacts'.  Returns the buckets looked up.
+  std::vector<int> Tick(const std::vector<Address>& contacts, Clock::time_point now = Clock::now());
+
+  // A random address sharing exactly 'bucket' leading bits with 'our_id'.
+  static Address RandomAddressInBucket(const Address& our_id, int bucket);
+
+  uint64_t LookupsSent() const { return lookups_sent_; }
+
+ private:
+  const Address our_id_;
+  Lookup lookup_;
+  const Clock::duration idle_period_;
+  const Clock::duration retry_interval_;
+  const std::size_t min_occupancy_;
+  const std::size_t max_lookups_per_tick_;
+  const Clock::time_point started_;
+  std::map<int, Clock::time_point> last_heard_;
+  std::map<int, Clock::time_point> last_looked_up_;
+  uint64_t lookups_sent_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_BUCKET_REFRESH_SCHEDULER_H_
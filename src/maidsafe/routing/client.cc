@@ -33,51 +33,58 @@ namespace maidsafe {
 
 namespace routing {
 
-Client::Client(asio::io_service& io_service, Identity our_id, asymm::Keys our_keys)
-    : crux_asio_service_(1),
-      io_service_(io_service),
-      our_id_(std::move(our_id)),
-      our_keys_(std::move(our_keys)),
-      message_id_(RandomUint32()),
-      bootstrap_node_(),
-      bootstrap_handler_(),
-      connected_peers_(),
-      filter_(std::chrono::minutes(20)),
-      sentinel_([](Address) {}, [](GroupAddress) {}) {}
+namespace {
+
+template <typename Fob>
+asymm::Keys KeysOf(const Fob& fob) {
+  asymm::Keys keys;
+  keys.private_key = fob.private_key();
+  keys.public_key = fob.public_key();
+  return keys;
+}
 
-Client::Client(asio::io_service& io_service, const passport::Maid& maid)
-    : crux_asio_service_(1),
-      io_service_(io_service),
-      our_id_(maid.name()),
-      our_keys_([&]() -> asymm::Keys {
-        asymm::Keys keys;
-        keys.private_key = maid.private_key();
-        keys.public_key = maid.public_key();
-        return keys;
-      }()),
-      message_id_(RandomUint32()),
-      bootstrap_node_(),
-      bootstrap_handler_(),
-      connected_peers_(),
-      filter_(std::chrono::minutes(20)),
-      sentinel_([](Address) {}, [](GroupAddress) {}) {}
+}  // unnamed namespace
+
+Client::Client(asio::io_service& io_service, Identity our_id, asymm::Keys our_keys,
+               RoutingConfig config)
+    : Client(nullptr, io_service, std::move(our_id), std::move(our_keys), std::move(config)) {}
+
+Client::Client(asio::io_service& io_service, const passport::Maid& maid, RoutingConfig config)
+    : Client(nullptr, io_service, Identity(maid.name()), KeysOf(maid), std::move(config)) {}
+
+Client::Client(asio::io_service& io_service, const passport::Mpid& mpid, RoutingConfig config)
+    : Client(nullptr, io_service, Identity(mpid.name()), KeysOf(mpid), std::move(config)) {}
 
-Client::Client(asio::io_service& io_service, const passport::Mpid& mpid)
-    : crux_asio_service_(1),
+Client::Client(BoostAsioService& crux_asio_service, asio::io_service& io_service, Identity our_id,
+               asymm::Keys our_keys, RoutingConfig config)
+    : Client(&crux_asio_service, io_service, std::move(our_id), std::move(our_keys),
+             std::move(config)) {}
+
+Client::Client(BoostAsioService& crux_asio_service, asio::io_service& io_service,
+               const passport::Maid& maid, RoutingConfig config)
+    : Client(&crux_asio_service, io_service, Identity(maid.name()), KeysOf(maid),
+             std::move(config)) {}
+
+Client::Client(BoostAsioService& crux_asio_service, asio::io_service& io_service,
+               const passport::Mpid& mpid, RoutingConfig config)
+    : Client(&crux_asio_service, io_service, Identity(mpid.name()), KeysOf(mpid),
+             std::move(config)) {}
+
+Client::Client(BoostAsioService* crux_asio_service, asio::io_service& io_service, Identity our_id,
+               asymm::Keys our_keys, RoutingConfig config)
+    : config_((config.Validate(), std::move(config))),
+      owned_crux_asio_service_(
+          crux_asio_service ? nullptr : new BoostAsioService(config_.crux_thread_count)),
+      crux_asio_service_(crux_asio_service ? *crux_asio_service : *owned_crux_asio_service_),
       io_service_(io_service),
-      our_id_(mpid.name()),
-      our_keys_([&]() -> asymm::Keys {
-        asymm::Keys keys;
-        keys.private_key = mpid.private_key();
-        keys.public_key = mpid.public_key();
-        return keys;
-      }()),
+      our_id_(std::move(our_id)),
+      our_keys_(std::move(our_keys)),
       message_id_(RandomUint32()),
       bootstrap_node_(),
       bootstrap_handler_(),
       connected_peers_(),
-      filter_(std::chrono::minutes(20)),
-      sentinel_([](Address) {}, [](GroupAddress) {}) {}
+      filter_(config_.filter_time_to_live),
+      sentinel_([](Address) {}, [](GroupAddress) {}, config_.sentinel_time_to_live) {}
 
 void Client::MessageReceived(const Address& /*peer_id*/, SerialisedMessage message) {
   InputVectorStream binary_input_stream(std::move(message));
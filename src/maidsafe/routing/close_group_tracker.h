@@ -0,0 +1,61 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_CLOSE_GROUP_TRACKER_H_
+#define MAIDSAFE_ROUTING_CLOSE_GROUP_TRACKER_H_
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "boost/optional/optional.hpp"
+
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Remembers the last close group seen so that each change to it is reported exactly once, as the
+// new group followed by the old one.
+class CloseGroupTracker {
+ public:
+  CloseGroupTracker() : current_(), epoch_(0) {}
+
+  boost::optional<CloseGroupDifference> Update(std::vector<Address> new_group) {
+    if (new_group == current_)
+      return boost::none;
+    auto changed(std::make_pair(new_group, std::move(current_)));
+    current_ = std::move(new_group);
+    ++epoch_;
+    return changed;
+  }
+
+  // Incremented by each change reported by Update.
+  uint64_t Epoch() const { return epoch_; }
+
+ private:
+  std::vector<Address> current_;
+  uint64_t epoch_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_CLOSE_GROUP_TRACKER_H_
@@ -0,0 +1,181 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/congestion_windows.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace maidsafe {
+
+namespace routing {
+
+const std::size_t CongestionWindows::kInitialWindow;
+
+CongestionWindows::CongestionWindows(Clock::duration timeout, std::size_t max_window,
+                                     std::size_t max_held, std::size_t max_groups,
+                                     Clock::duration idle_time)
+    : timeout_(timeout),
+      max_window_(std::max(max_window, kInitialWindow)),
+      max_held_(max_held),
+      max_groups_(max_groups),
+      idle_time_(idle_time),
+      groups_(),
+      requests_(),
+      decreases_(0),
+      dropped_(0) {}
+
+Address CongestionWindows::GroupOf(const Address& destination, int leading_bits) {
+  assert(leading_bits >= 0);
+  auto result(destination.string());
+  const auto bits(std::min(static_cast<std::size_t>(leading_bits), result.size() * 8));
+  const auto byte(bits / 8);
+  if (byte == result.size())
+    return destination;
+  result[byte] = static_cast<char>(static_cast<unsigned char>(result[byte]) &
+                                   static_cast<unsigned char>(~(0xFF >> (bits % 8))));
+  std::fill(std::begin(result) + byte + 1, std::end(result), 0);
+  return Address(result);
+}
+
+bool CongestionWindows::TrySend(const Address& group, MessageId message_id,
+                                Clock::time_point now) {
+  auto found(groups_.find(group));
+  if (found == std::end(groups_)) {
+    if (groups_.size() >= max_groups_ && !EvictIdlest())
+      return true;
+    found = groups_.emplace(group, Group{static_cast<double>(kInitialWindow), {}, {},
+                                         Clock::time_point::min(), now}).first;
+  }
+  auto& state(found->second);
+  if (!state.held.empty() || state.in_flight.size() >= static_cast<std::size_t>(state.window))
+    return false;
+  state.in_flight.emplace_back(message_id, now);
+  state.last_active = now;
+  requests_[message_id] = group;
+  return true;
+}
+
+bool CongestionWindows::Hold(const Address& group, MessageId message_id, Address destination,
+                             SerialisedMessage message) {
+  auto found(groups_.find(group));
+  if (found == std::end(groups_) || found->second.held.size() >= max_held_) {
+    ++dropped_;
+    return false;
+  }
+  found->second.held.push_back(Held{message_id, std::move(destination), std::move(message)});
+  return true;
+}
+
+std::vector<std::pair<Address, SerialisedMessage>> CongestionWindows::Acknowledge(
+    MessageId message_id, bool congestion_experienced, Clock::time_point now) {
+  std::vector<std::pair<Address, SerialisedMessage>> released;
+  // a group answers a request once per member, so only the first answer frees its place
+  auto request(requests_.find(message_id));
+  if (request == std::end(requests_))
+    return released;
+  auto found(groups_.find(request->second));
+  requests_.erase(request);
+  if (found == std::end(groups_))
+    return released;
+  auto& state(found->second);
+  auto in_flight(std::find_if(std::begin(state.in_flight), std::end(state.in_flight),
+                              [&](const std::pair<MessageId, Clock::time_point>& sent) {
+                                return sent.first == message_id;
+                              }));
+  if (in_flight == std::end(state.in_flight))
+    return released;
+  const auto sent(in_flight->second);
+  state.in_flight.erase(in_flight);
+  state.last_active = now;
+  if (congestion_experienced)
+    Decrease(state, sent, now);
+  else
+    state.window = std::min(state.window + 1.0 / state.window, static_cast<double>(max_window_));
+  Release(found, now, released);
+  return released;
+}
+
+std::vector<std::pair<Address, SerialisedMessage>> CongestionWindows::Expire(
+    Clock::time_point now) {
+  std::vector<std::pair<Address, SerialisedMessage>> released;
+  for (auto itr(std::begin(groups_)); itr != std::end(groups_);) {
+    auto& state(itr->second);
+    while (!state.in_flight.empty() && state.in_flight.front().second + timeout_ < now) {
+      Decrease(state, state.in_flight.front().second, now);
+      requests_.erase(state.in_flight.front().first);
+      state.in_flight.pop_front();
+    }
+    Release(itr, now, released);
+    // the window learned is kept across pauses of a few round trips, so is only forgotten once the
+    // group has gone unused for much longer
+    if (Idle(state) && state.last_active + idle_time_ <= now)
+      itr = groups_.erase(itr);
+    else
+      ++itr;
+  }
+  return released;
+}
+
+double CongestionWindows::Window(const Address& group) const {
+  auto found(groups_.find(group));
+  return found == std::end(groups_) ? static_cast<double>(kInitialWindow) : found->second.window;
+}
+
+std::size_t CongestionWindows::InFlight(const Address& group) const {
+  auto found(groups_.find(group));
+  return found == std::end(groups_) ? 0 : found->second.in_flight.size();
+}
+
+bool CongestionWindows::EvictIdlest() {
+  auto idlest(std::end(groups_));
+  for (auto itr(std::begin(groups_)); itr != std::end(groups_); ++itr) {
+    if (Idle(itr->second) &&
+        (idlest == std::end(groups_) || itr->second.last_active < idlest->second.last_active))
+      idlest = itr;
+  }
+  if (idlest == std::end(groups_))
+    return false;
+  groups_.erase(idlest);
+  return true;
+}
+
+void CongestionWindows::Decrease(Group& group, Clock::time_point sent, Clock::time_point now) {
+  if (sent <= group.last_decrease)
+    return;
+  group.window = std::max(group.window / 2.0, 1.0);
+  group.last_decrease = now;
+  ++decreases_;
+}
+
+void CongestionWindows::Release(Groups::iterator group, Clock::time_point now,
+                                std::vector<std::pair<Address, SerialisedMessage>>& released) {
+  auto& state(group->second);
+  while (!state.held.empty() && state.in_flight.size() < static_cast<std::size_t>(state.window)) {
+    auto& held(state.held.front());
+    state.in_flight.emplace_back(held.message_id, now);
+    requests_[held.message_id] = group->first;
+    released.emplace_back(std::move(held.destination), std::move(held.message));
+    state.held.pop_front();
+  }
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
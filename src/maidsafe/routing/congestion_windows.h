@@ -0,0 +1,131 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_CONGESTION_WINDOWS_H_
+#define MAIDSAFE_ROUTING_CONGESTION_WINDOWS_H_
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Limits the requests we have in flight towards each destination group, adapting the limit the way
+// TCP does to explicit congestion notification.  Requests are counted against the group holding
+// their destination, identified by the destination's leading bits (see GroupOf), so requests for
+// different names held by the same group share one window.  Each response which comes back
+// unmarked grows the group's window by about one request per window's worth of responses, while a
+// response marked congestion-experienced, or a request left unanswered for 'timeout', halves it.
+// The window is halved at most once per round trip: only for requests sent after the previous cut.
+// Requests which don't fit the window are held, up to 'max_held' per group, and released as
+// responses free space.  A group's window outlives gaps between bursts of requests: it is only
+// forgotten, so starts again from the initial window, once the group has been idle for
+// 'idle_time'.  At most 'max_groups' groups are tracked, the longest idle making way for a new one;
+// requests to further groups are not limited.  Not thread-safe.
+class CongestionWindows {
+ public:
+  using Clock = std::chrono::steady_clock;
+  static const std::size_t kInitialWindow = 4;
+
+  explicit CongestionWindows(Clock::duration timeout = std::chrono::seconds(10),
+                             std::size_t max_window = 64, std::size_t max_held = 256,
+                             std::size_t max_groups = 1024,
+                             Clock::duration idle_time = std::chrono::minutes(1));
+  CongestionWindows(const CongestionWindows&) = delete;
+  CongestionWindows(CongestionWindows&&) = delete;
+  ~CongestionWindows() = default;
+  CongestionWindows& operator=(const CongestionWindows&) = delete;
+  CongestionWindows& operator=(CongestionWindows&&) = delete;
+
+  // The group holding 'destination', given that groups share 'leading_bits' leading bits: the
+  // destination with all later bits cleared.
+  static Address GroupOf(const Address& destination, int leading_bits);
+
+  // Returns true if request 'message_id' may be sent to 'group' now, in which case it is counted as
+  // in flight.  Otherwise the caller should Hold it.
+  bool TrySend(const Address& group, MessageId message_id, Clock::time_point now = Clock::now());
+  // Holds 'message' for 'destination' until the window towards 'group' has room for it.  Returns
+  // false, dropping it, if too many are held already.
+  bool Hold(const Address& group, MessageId message_id, Address destination,
+            SerialisedMessage message);
+  // Records a response to our request 'message_id'.  Returns any held requests which now fit the
+  // window, each with its destination; these are counted as in flight and must be sent.
+  std::vector<std::pair<Address, SerialisedMessage>> Acknowledge(
+      MessageId message_id, bool congestion_experienced, Clock::time_point now = Clock::now());
+  // Treats requests unanswered for longer than 'timeout' as lost, and forgets groups idle for
+  // 'idle_time'.  Returns the held requests which now fit their groups' windows, each with its
+  // destination.
+  std::vector<std::pair<Address, SerialisedMessage>> Expire(Clock::time_point now = Clock::now());
+
+  // The current window and requests in flight towards 'group'.
+  double Window(const Address& group) const;
+  std::size_t InFlight(const Address& group) const;
+  std::size_t size() const { return groups_.size(); }
+  uint64_t Decreases() const { return decreases_; }
+  uint64_t Dropped() const { return dropped_; }
+
+ private:
+  struct Held {
+    MessageId message_id;
+    Address destination;
+    SerialisedMessage message;
+  };
+  struct Group {
+    double window;
+    // requests in flight, oldest first
+    std::deque<std::pair<MessageId, Clock::time_point>> in_flight;
+    std::deque<Held> held;
+    // requests sent at or before this time don't cut the window again
+    Clock::time_point last_decrease;
+    // when a request was last sent or answered
+    Clock::time_point last_active;
+  };
+  using Groups = std::map<Address, Group>;
+
+  bool Idle(const Group& group) const { return group.in_flight.empty() && group.held.empty(); }
+  // makes room for another group by forgetting the longest idle one, if any is idle
+  bool EvictIdlest();
+  void Decrease(Group& group, Clock::time_point sent, Clock::time_point now);
+  // moves held requests into flight while the window allows
+  void Release(Groups::iterator group, Clock::time_point now,
+               std::vector<std::pair<Address, SerialisedMessage>>& released);
+
+  const Clock::duration timeout_;
+  const std::size_t max_window_;
+  const std::size_t max_held_;
+  const std::size_t max_groups_;
+  const Clock::duration idle_time_;
+  Groups groups_;
+  // the group each request in flight was counted against
+  std::map<MessageId, Address> requests_;
+  uint64_t decreases_;
+  uint64_t dropped_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_CONGESTION_WINDOWS_H_
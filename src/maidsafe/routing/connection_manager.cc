@@ -28,9 +28,13 @@
 #include "boost/asio/spawn.hpp"
 
 #include "maidsafe/common/convert.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/make_unique.h"
 
 #include "maidsafe/routing/peer_node.h"
+#include "maidsafe/routing/queue_depth_order.h"
 #include "maidsafe/routing/routing_table.h"
+#include "maidsafe/routing/shared_memory_ring.h"
 #include "maidsafe/routing/types.h"
 #include "maidsafe/routing/async_exchange.h"
 
@@ -44,12 +48,19 @@ using std::move;
 using boost::none_t;
 using boost::optional;
 
-ConnectionManager::ConnectionManager(boost::asio::io_service& ios, PublicPmid our_fob)
+ConnectionManager::ConnectionManager(boost::asio::io_service& ios, PublicPmid our_fob,
+                                     const RoutingConfig& config)
     : io_service_(ios),
       our_fob_(std::move(our_fob)),
       our_id_(our_fob_.Name()),
+      max_message_size_(config.max_message_size),
+      exchange_buffer_size_(config.exchange_buffer_size),
+      congested_peer_bytes_(config.congested_peer_bytes),
+      shared_memory_ring_bytes_(config.shared_memory_ring_bytes),
+      pending_accepts_per_port_(config.pending_accepts_per_port),
+      host_id_(shared_memory_ring_bytes_ == 0 ? std::string() : LocalHostId()),
       peers_(Comparison(our_id_)),
-      current_close_group_(),
+      close_group_tracker_(),
       destroy_indicator_(new boost::none_t()) {}
 
 bool ConnectionManager::IsManaged(const Address& node_id) const {
@@ -57,10 +68,14 @@ bool ConnectionManager::IsManaged(const Address& node_id) const {
   // return routing_table_.CheckNode(node_to_add);
 }
 
-std::set<Address, ConnectionManager::Comparison> ConnectionManager::GetTarget(
-    const Address& target_node) const {
+std::vector<Address> ConnectionManager::GetTarget(const Address& target_node) const {
   // TODO(PeterJ): The previous code was quite more complicated, so recheck correctness of this one.
-  return std::set<Address, Comparison>(Comparison(target_node));
+  std::vector<Address> result;
+  OrderByQueueDepth(target_node, result, congested_peer_bytes_, [this](const Address& peer) {
+    auto found(peers_.find(peer));
+    return found == peers_.end() ? size_t{0} : found->second.PendingSendBytes();
+  });
+  return result;
   // for (const auto& peer : peers_) {
   //  result.insert(peer.first);
   // }
@@ -86,14 +101,26 @@ optional<CloseGroupDifference> ConnectionManager::DropNode(const Address& their_
 
 // acceptor_(io_service_, crux::endpoint(boost::asio::ip::udp::v4(), 5483)),
 void ConnectionManager::StartAccepting(unsigned short port) {
-  auto acceptor_i = acceptors_.find(port);
+  if (acceptors_.count(port) != 0)
+    return;
 
-  if (acceptor_i == acceptors_.end()) {
-    crux::endpoint endpoint(boost::asio::ip::udp::v4(), port);
-    auto acceptor = std::unique_ptr<crux::acceptor>(new crux::acceptor(io_service_, endpoint));
-    auto pair = acceptors_.insert(std::make_pair(port, std::move(acceptor)));
-    acceptor_i = pair.first;
-  }
+  crux::endpoint endpoint(boost::asio::ip::udp::v4(), port);
+  auto acceptor = std::unique_ptr<crux::acceptor>(new crux::acceptor(io_service_, endpoint));
+  acceptors_.insert(std::make_pair(port, std::move(acceptor)));
+
+  for (unsigned i(0); i < pending_accepts_per_port_; ++i)
+    Accept(port);
+}
+
+// Each completed accept re-arms itself before handshaking, so the number outstanding on the port
+// stays constant.  There is no strand: accept and handshake handlers, like everything else using
+// ConnectionManager, are serialised only by the crux service having a single thread (which
+// RoutingConfig::Validate insists on).  Extra accepts therefore shorten the wait for an accept to
+// be armed, but handshakes are still processed one at a time.
+void ConnectionManager::Accept(unsigned short port) {
+  auto acceptor_i = acceptors_.find(port);
+  if (acceptor_i == acceptors_.end())
+    return;
 
   auto socket = make_shared<crux::socket>(io_service_);
 
@@ -105,15 +132,15 @@ void ConnectionManager::StartAccepting(unsigned short port) {
     if (!destroy_guard.lock())
       return;
 
-    if (error) {
-      if (error == boost::asio::error::operation_aborted) {
-        return;
-      }
-    }
+    if (error == boost::asio::error::operation_aborted)
+      return;
 
-    StartAccepting(port);
+    Accept(port);
 
-    AsyncExchange(*socket, Serialise(our_fob_),
+    if (error)
+      return;
+
+    AsyncExchange(*socket, Handshake(),
                   [=](boost::system::error_code error, SerialisedMessage data) {
       if (!destroy_guard.lock())
         return;
@@ -121,11 +148,13 @@ void ConnectionManager::StartAccepting(unsigned short port) {
       if (error)
         return;
 
+      const auto their_host_id(TakeHostId(data));
       PublicPmid their_public_pmid(Parse<PublicPmid>(std::move(data)));
       Address their_id(their_public_pmid.Name());
       InsertPeer(PeerNode(NodeInfo(std::move(their_id), std::move(their_public_pmid), true),
-                          std::move(socket)));
-    });
+                          std::move(socket), max_message_size_),
+                 their_host_id);
+    }, exchange_buffer_size_);
   });
 }
 
@@ -157,7 +186,7 @@ void ConnectionManager::AddNode(optional<NodeInfo> assumed_node_info, EndpointPa
       return;
     }
 
-    AsyncExchange(*socket, Serialise(our_fob_),
+    AsyncExchange(*socket, Handshake(),
                   [=](boost::system::error_code error, SerialisedMessage data) {
       auto socket = weak_socket.lock();
 
@@ -169,6 +198,7 @@ void ConnectionManager::AddNode(optional<NodeInfo> assumed_node_info, EndpointPa
       if (error)
         return;
 
+      const auto their_host_id(TakeHostId(data));
       PublicPmid their_public_pmid(Parse<PublicPmid>(std::move(data)));
       Address their_id(their_public_pmid.Name());
       NodeInfo their_node_info(std::move(their_id), std::move(their_public_pmid), true);
@@ -176,12 +206,19 @@ void ConnectionManager::AddNode(optional<NodeInfo> assumed_node_info, EndpointPa
       if (assumed_node_info && *assumed_node_info != their_node_info)
         return;
 
-      InsertPeer(PeerNode(std::move(their_node_info), std::move(socket)));
-    });
+      InsertPeer(PeerNode(std::move(their_node_info), std::move(socket), max_message_size_),
+                 their_host_id);
+    }, exchange_buffer_size_);
   });
 }
 
-void ConnectionManager::InsertPeer(PeerNode&& node_arg) {
+SerialisedMessage ConnectionManager::Handshake() const {
+  auto handshake(Serialise(our_fob_));
+  AppendHostId(host_id_, handshake);
+  return handshake;
+}
+
+void ConnectionManager::InsertPeer(PeerNode&& node_arg, const std::string& their_host_id) {
   const auto& id = node_arg.id();
   const auto pair = peers_.insert(std::make_pair(id, std::move(node_arg)));
 
@@ -191,11 +228,37 @@ void ConnectionManager::InsertPeer(PeerNode&& node_arg) {
 
   auto& node = pair.first->second;
 
+  // Both ends see the same ids, so both set up shared memory, though each only sends through it
+  // once the other has opened its ring, carrying on with UDP otherwise.  Its messages are delivered
+  // as though they had arrived on the UDP connection, which carries on receiving in case the peer
+  // falls back to it.
+  if (!host_id_.empty() && their_host_id == host_id_) {
+    weak_ptr<none_t> destroy_guard = destroy_indicator_;
+    const Address their_id(node.id());
+    try {
+      node.UseSharedMemory(maidsafe::make_unique<SharedMemoryChannel>(
+          io_service_, our_id_, their_id, shared_memory_ring_bytes_,
+          [=](SerialisedMessage bytes) {
+            if (!destroy_guard.lock() || !IsManaged(their_id))
+              return;
+            if (auto on_receive = on_receive_)
+              on_receive(their_id, bytes);
+          }));
+    } catch (const std::exception& e) {
+      LOG(kWarning) << "Cannot use shared memory with a local peer: " << e.what();
+    }
+  }
+
   StartReceiving(node);
 
   if (on_connection_added_) {
     on_connection_added_(node.id());
   }
+
+  auto close_group_difference(GroupChanged());
+  if (close_group_difference && on_close_group_changed_) {
+    on_close_group_changed_(std::move(*close_group_difference));
+  }
 }
 
 void ConnectionManager::StartReceiving(PeerNode& node) {
@@ -233,14 +296,7 @@ optional<CloseGroupDifference> ConnectionManager::GroupChanged() {
   std::vector<Address> new_group_ids;
   for (const auto& group_member_public_pmid : new_group)
     new_group_ids.push_back(group_member_public_pmid.Name());
-
-  if (new_group_ids != current_close_group_) {
-    auto changed = std::make_pair(new_group_ids, current_close_group_);
-    current_close_group_ = new_group_ids;
-    return changed;
-  }
-
-  return boost::none;
+  return close_group_tracker_.Update(std::move(new_group_ids));
 }
 
 }  // namespace routing
@@ -40,7 +40,8 @@ destiations. In that case request a close_group message for this node.
 
 #include <functional>
 #include <map>
-#include <set>
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "asio/io_service.hpp"
@@ -49,6 +50,8 @@ destiations. In that case request a close_group message for this node.
 #include "maidsafe/crux/socket.hpp"
 #include "maidsafe/crux/acceptor.hpp"
 
+#include "maidsafe/routing/close_group_tracker.h"
+#include "maidsafe/routing/routing_config.h"
 #include "maidsafe/routing/routing_table.h"
 #include "maidsafe/routing/types.h"
 #include "maidsafe/routing/peer_node.h"
@@ -73,7 +76,8 @@ class ConnectionManager {
   };
 
  public:
-  ConnectionManager(boost::asio::io_service& ios, PublicPmid our_fob);
+  ConnectionManager(boost::asio::io_service& ios, PublicPmid our_fob,
+                    const RoutingConfig& config = RoutingConfig());
 
   ConnectionManager(const ConnectionManager&) = delete;
   ConnectionManager(ConnectionManager&&) = delete;
@@ -82,7 +86,9 @@ class ConnectionManager {
   ConnectionManager& operator=(ConnectionManager&&) = delete;
 
   bool IsManaged(const Address& node_to_add) const;
-  std::set<Address, Comparison> GetTarget(const Address& target_node) const;
+  // Returns the peers a message for 'target_node' should be sent to, closest to the target first
+  // except that congested peers follow any making the same progress; see OrderByQueueDepth.
+  std::vector<Address> GetTarget(const Address& target_node) const;
   // boost::optional<CloseGroupDifference> LostNetworkConnection(const Address& node);
   // routing wishes to drop a specific node (may be a node we cannot connect to)
   boost::optional<CloseGroupDifference> DropNode(const Address& their_id);
@@ -113,6 +119,19 @@ class ConnectionManager {
 
   const Address& OurId() const { return our_id_; }
 
+  // Incremented each time our close group changes, so anything derived from the group can be
+  // tagged with the epoch it was built in and discarded once that has passed.
+  uint64_t CloseGroupEpoch() const { return close_group_tracker_.Epoch(); }
+
+  // The ids of all connected peers, closest to us first.
+  std::vector<Address> Peers() const {
+    std::vector<Address> result;
+    result.reserve(peers_.size());
+    for (const auto& peer : peers_)
+      result.push_back(peer.first);
+    return result;
+  }
+
   boost::optional<asymm::PublicKey> GetPublicKey(const Address& node) const {
     auto found_i = peers_.find(node);
     if (found_i == peers_.end()) { return boost::none; }
@@ -130,6 +149,8 @@ class ConnectionManager {
     return &i->second;
   }
 
+  // Listens on 'port', keeping the configured number of accepts outstanding on it.  Does nothing
+  // if we already listen on 'port'.
   void StartAccepting(unsigned short port);
 
   template<class Handler /* void(NodeId) */>
@@ -142,6 +163,12 @@ class ConnectionManager {
     on_receive_ = std::move(handler);
   }
 
+  // Invoked whenever a newly connected peer changes our close group.
+  template<class Handler /* void(CloseGroupDifference) */>
+  void SetOnCloseGroupChanged(Handler handler) {
+    on_close_group_changed_ = std::move(handler);
+  }
+
   void Shutdown() {
     acceptors_.clear();
     being_connected_.clear();
@@ -150,7 +177,10 @@ class ConnectionManager {
 
  private:
   boost::optional<CloseGroupDifference> GroupChanged();
-  void InsertPeer(PeerNode&&);
+  // 'their_host_id' is as sent in their handshake
+  void InsertPeer(PeerNode&&, const std::string& their_host_id);
+  SerialisedMessage Handshake() const;
+  void Accept(unsigned short port);
   std::weak_ptr<boost::none_t> DestroyGuard() { return destroy_indicator_; }
   void StartReceiving(PeerNode&);
 
@@ -159,15 +189,23 @@ class ConnectionManager {
 
   std::function<void(Address)> on_connection_added_;
   std::function<void(Address, const SerialisedMessage&)> on_receive_;
+  std::function<void(CloseGroupDifference)> on_close_group_changed_;
 
   PublicPmid our_fob_;
   Address our_id_;
+  const size_t max_message_size_;
+  const size_t exchange_buffer_size_;
+  const size_t congested_peer_bytes_;
+  const size_t shared_memory_ring_bytes_;
+  const unsigned pending_accepts_per_port_;
+  // empty unless we may use shared memory with peers on our host
+  const std::string host_id_;
 
   std::map<unsigned short, std::unique_ptr<crux::acceptor>> acceptors_;  // NOLINT
   std::map<crux::endpoint, std::shared_ptr<crux::socket>> being_connected_;
   std::map<Address, PeerNode, Comparison> peers_;
 
-  std::vector<Address> current_close_group_;
+  CloseGroupTracker close_group_tracker_;
 
   std::shared_ptr<boost::none_t> destroy_indicator_;
 };
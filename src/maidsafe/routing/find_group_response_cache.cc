@@ -0,0 +1,74 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/find_group_response_cache.h"
+
+#include <utility>
+
+namespace maidsafe {
+
+namespace routing {
+
+FindGroupResponseCache::FindGroupResponseCache(std::size_t max_entries)
+    : max_entries_(max_entries),
+      epoch_(0),
+      entries_(),
+      oldest_first_(),
+      hits_(0),
+      misses_(0) {}
+
+const FindGroupResponseCache::Entry* FindGroupResponseCache::Get(const Address& target,
+                                                                 uint64_t epoch) {
+  if (MoveToEpoch(epoch)) {
+    auto found(entries_.find(target));
+    if (found != std::end(entries_)) {
+      ++hits_;
+      return &found->second;
+    }
+  }
+  ++misses_;
+  return nullptr;
+}
+
+void FindGroupResponseCache::Add(Address target, uint64_t epoch, Entry entry) {
+  if (max_entries_ == 0 || !MoveToEpoch(epoch))
+    return;
+  auto inserted(entries_.emplace(target, std::move(entry)));
+  if (!inserted.second)
+    return;
+  oldest_first_.push_back(std::move(target));
+  if (oldest_first_.size() > max_entries_) {
+    entries_.erase(oldest_first_.front());
+    oldest_first_.pop_front();
+  }
+}
+
+bool FindGroupResponseCache::MoveToEpoch(uint64_t epoch) {
+  if (epoch < epoch_)
+    return false;
+  if (epoch > epoch_) {
+    entries_.clear();
+    oldest_first_.clear();
+    epoch_ = epoch;
+  }
+  return true;
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
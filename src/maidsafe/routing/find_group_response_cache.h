@@ -0,0 +1,80 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_FIND_GROUP_RESPONSE_CACHE_H_
+#define MAIDSAFE_ROUTING_FIND_GROUP_RESPONSE_CACHE_H_
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <vector>
+
+#include "maidsafe/common/rsa.h"
+#include "maidsafe/passport/types.h"
+
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Signed FindGroupResponse contents, reused while our close group is unchanged.  A response depends
+// only on its target and our close group, so during a join storm only the first FindGroup for each
+// target costs an RSA signature.  Entries are tagged with the close group epoch they were built in
+// and a lookup in a later epoch empties the cache.  At most 'max_entries' targets are held, the
+// oldest being dropped first.  Not thread-safe.
+class FindGroupResponseCache {
+ public:
+  struct Entry {
+    std::vector<passport::PublicPmid> group;
+    asymm::Signature signature;
+  };
+
+  explicit FindGroupResponseCache(std::size_t max_entries = 256);
+  FindGroupResponseCache(const FindGroupResponseCache&) = delete;
+  FindGroupResponseCache(FindGroupResponseCache&&) = delete;
+  ~FindGroupResponseCache() = default;
+  FindGroupResponseCache& operator=(const FindGroupResponseCache&) = delete;
+  FindGroupResponseCache& operator=(FindGroupResponseCache&&) = delete;
+
+  // Returns the entry for 'target' built in 'epoch', or nullptr.  The pointer is invalidated by
+  // the next call to Get or Add.
+  const Entry* Get(const Address& target, uint64_t epoch);
+  // Entries built in an epoch which has since passed are ignored.
+  void Add(Address target, uint64_t epoch, Entry entry);
+
+  uint64_t Hits() const { return hits_; }
+  uint64_t Misses() const { return misses_; }
+
+ private:
+  // empties the cache if 'epoch' is newer than its entries; returns false if it's older
+  bool MoveToEpoch(uint64_t epoch);
+
+  const std::size_t max_entries_;
+  uint64_t epoch_;
+  std::map<Address, Entry> entries_;
+  std::deque<Address> oldest_first_;
+  uint64_t hits_;
+  uint64_t misses_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_FIND_GROUP_RESPONSE_CACHE_H_
@@ -0,0 +1,144 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/group_key_prefetcher.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace maidsafe {
+
+namespace routing {
+
+GroupKeyPrefetcher::GroupKeyPrefetcher(SendGetGroupKey send_get_group_key,
+                                       Clock::duration refetch_interval, std::size_t burst,
+                                       Clock::duration refill_period,
+                                       Clock::duration remember_for, std::size_t max_groups)
+    : send_get_group_key_(std::move(send_get_group_key)),
+      refetch_interval_(refetch_interval),
+      burst_(burst),
+      refill_period_(refill_period),
+      remember_for_(remember_for),
+      max_groups_(max_groups),
+      tokens_(burst),
+      last_refill_(Clock::now()),
+      last_requested_(),
+      heard_(),
+      requests_sent_(0),
+      requests_throttled_(0) {}
+
+void GroupKeyPrefetcher::Heard(const GroupAddress& group, Clock::time_point now) {
+  auto found(heard_.find(group));
+  if (found != std::end(heard_)) {
+    found->second = now;
+    return;
+  }
+  if (max_groups_ == 0)
+    return;
+  if (heard_.size() >= max_groups_) {
+    heard_.erase(std::min_element(std::begin(heard_), std::end(heard_),
+                                  [](const std::pair<const GroupAddress, Clock::time_point>& lhs,
+                                     const std::pair<const GroupAddress, Clock::time_point>& rhs) {
+                                    return lhs.second < rhs.second;
+                                  }));
+  }
+  heard_.emplace(group, now);
+}
+
+std::vector<GroupAddress> GroupKeyPrefetcher::GroupsToPrefetch(
+    const CloseGroupDifference& close_group_difference, int leading_bits, Clock::time_point now) {
+  const auto& new_group(close_group_difference.first);
+  const auto& old_group(close_group_difference.second);
+  std::vector<Address> changed;
+  for (const auto& node : new_group) {
+    if (std::find(std::begin(old_group), std::end(old_group), node) == std::end(old_group))
+      changed.push_back(node);
+  }
+  for (const auto& node : old_group) {
+    if (std::find(std::begin(new_group), std::end(new_group), node) == std::end(new_group))
+      changed.push_back(node);
+  }
+  std::vector<GroupAddress> groups;
+  for (auto itr(std::begin(heard_)); itr != std::end(heard_);) {
+    if (now - itr->second >= remember_for_) {
+      itr = heard_.erase(itr);
+      continue;
+    }
+    const auto& group(itr->first);
+    if (std::any_of(std::begin(changed), std::end(changed), [&](const Address& node) {
+          return CommonLeadingBits(node, group.data) >= leading_bits;
+        }))
+      groups.push_back(group);
+    ++itr;
+  }
+  return groups;
+}
+
+std::size_t GroupKeyPrefetcher::Prefetch(const std::vector<GroupAddress>& groups,
+                                         Clock::time_point now) {
+  Refill(now);
+  Prune(now);
+  std::size_t sent(0);
+  for (const auto& group : groups) {
+    if (last_requested_.count(group) != 0)
+      continue;
+    if (tokens_ == 0) {
+      ++requests_throttled_;
+      continue;
+    }
+    --tokens_;
+    last_requested_.emplace(group, now);
+    send_get_group_key_(group);
+    ++requests_sent_;
+    ++sent;
+  }
+  return sent;
+}
+
+void GroupKeyPrefetcher::Refill(Clock::time_point now) {
+  if (refill_period_ <= Clock::duration::zero()) {
+    tokens_ = burst_;
+    last_refill_ = now;
+    return;
+  }
+  if (now <= last_refill_)
+    return;
+  const auto periods(static_cast<std::size_t>((now - last_refill_) / refill_period_));
+  if (periods == 0)
+    return;
+  if (periods >= burst_ - tokens_) {
+    tokens_ = burst_;
+    last_refill_ = now;
+  } else {
+    tokens_ += periods;
+    last_refill_ += refill_period_ * static_cast<Clock::rep>(periods);
+  }
+}
+
+void GroupKeyPrefetcher::Prune(Clock::time_point now) {
+  for (auto itr(std::begin(last_requested_)); itr != std::end(last_requested_);) {
+    if (now - itr->second >= refetch_interval_)
+      itr = last_requested_.erase(itr);
+    else
+      ++itr;
+  }
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,99 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_GROUP_KEY_PREFETCHER_H_
+#define MAIDSAFE_ROUTING_GROUP_KEY_PREFETCHER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Refreshes Sentinel's group keys for the groups we hear from once churn may have changed their
+// membership, so that messages signed by a group's new members don't wait on a key round trip.
+// Groups are learned from the FromGroup of messages received within 'remember_for' (at most
+// 'max_groups' of them).  Keys already held are fetched again, as they may lack a new member's key.
+// Requests are rate limited per group (no group is asked twice within 'refetch_interval') and
+// overall (a token bucket holding up to 'burst' requests, refilled at one request per
+// 'refill_period').  Groups refused by the limiter are left to Sentinel, which fetches keys itself
+// when a group's messages fail to validate against those it holds.  Not thread-safe.
+class GroupKeyPrefetcher {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit GroupKeyPrefetcher(SendGetGroupKey send_get_group_key,
+                              Clock::duration refetch_interval = std::chrono::minutes(1),
+                              std::size_t burst = GroupSize,
+                              Clock::duration refill_period = std::chrono::milliseconds(100),
+                              Clock::duration remember_for = std::chrono::minutes(10),
+                              std::size_t max_groups = 256);
+  GroupKeyPrefetcher(const GroupKeyPrefetcher&) = delete;
+  GroupKeyPrefetcher(GroupKeyPrefetcher&&) = delete;
+  ~GroupKeyPrefetcher() = default;
+  GroupKeyPrefetcher& operator=(const GroupKeyPrefetcher&) = delete;
+  GroupKeyPrefetcher& operator=(GroupKeyPrefetcher&&) = delete;
+
+  // Notes that a message claiming to be from 'group' has been received.  Once 'max_groups' are
+  // known, the one heard from longest ago is forgotten to make room.
+  void Heard(const GroupAddress& group, Clock::time_point now = Clock::now());
+
+  // The groups heard from whose membership 'close_group_difference' may have changed, i.e. those
+  // sharing at least 'leading_bits' leading bits with a node which has joined or left our close
+  // group.  'leading_bits' is the number our close group shares with us, so approximates how
+  // close a node must be to a group's address to be one of its members.
+  std::vector<GroupAddress> GroupsToPrefetch(const CloseGroupDifference& close_group_difference,
+                                             int leading_bits,
+                                             Clock::time_point now = Clock::now());
+
+  // Requests the keys of each group in 'groups' which we haven't recently asked for.  Returns the
+  // number of requests sent.
+  std::size_t Prefetch(const std::vector<GroupAddress>& groups, Clock::time_point now = Clock::now());
+
+  std::size_t GroupsHeard() const { return heard_.size(); }
+  uint64_t RequestsSent() const { return requests_sent_; }
+  uint64_t RequestsThrottled() const { return requests_throttled_; }
+
+ private:
+  void Refill(Clock::time_point now);
+  void Prune(Clock::time_point now);
+
+  SendGetGroupKey send_get_group_key_;
+  const Clock::duration refetch_interval_;
+  const std::size_t burst_;
+  const Clock::duration refill_period_;
+  const Clock::duration remember_for_;
+  const std::size_t max_groups_;
+  std::size_t tokens_;
+  Clock::time_point last_refill_;
+  std::map<GroupAddress, Clock::time_point> last_requested_;
+  std::map<GroupAddress, Clock::time_point> heard_;
+  uint64_t requests_sent_;
+  uint64_t requests_throttled_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_GROUP_KEY_PREFETCHER_H_
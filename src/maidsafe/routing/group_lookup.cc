@@ -0,0 +1,143 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/group_lookup.h"
+
+#include <utility>
+
+namespace maidsafe {
+
+namespace routing {
+
+GroupLookup::GroupLookup(Address target, const std::vector<Address>& seeds,
+                         SendFindGroup send_find_group, std::size_t parallelism,
+                         std::size_t group_size, std::size_t max_rounds)
+    : target_(std::move(target)),
+      send_find_group_(std::move(send_find_group)),
+      parallelism_(parallelism),
+      group_size_(group_size),
+      max_rounds_(max_rounds),
+      shortlist_(Comparison(target_)),
+      in_flight_(0),
+      closest_at_round_start_(),
+      improved_(true),
+      done_(false),
+      rounds_(0),
+      messages_sent_(0) {
+  for (const auto& seed : seeds)
+    Merge(seed);
+}
+
+void GroupLookup::Start() { MaybeStartRound(); }
+
+void GroupLookup::HandleResponse(const Address& from, const std::vector<Address>& group) {
+  if (done_)
+    return;
+  for (const auto& node : group)
+    Merge(node);
+  auto found(shortlist_.find(from));
+  if (found == std::end(shortlist_)) {
+    shortlist_.emplace(from, State::responded);
+  } else {
+    // a late answer from a node timed out earlier still shows it to be alive
+    if (found->second == State::in_flight)
+      --in_flight_;
+    found->second = State::responded;
+  }
+  MaybeStartRound();
+}
+
+void GroupLookup::HandleRoundTimeout() {
+  if (done_)
+    return;
+  for (auto& node : shortlist_) {
+    if (node.second == State::in_flight)
+      node.second = State::failed;
+  }
+  in_flight_ = 0;
+  MaybeStartRound();
+}
+
+std::vector<Address> GroupLookup::Result() const {
+  std::vector<Address> result;
+  for (const auto& node : shortlist_) {
+    if (result.size() == group_size_)
+      break;
+    if (node.second == State::responded)
+      result.push_back(node.first);
+  }
+  return result;
+}
+
+void GroupLookup::Merge(const Address& node) { shortlist_.emplace(node, State::candidate); }
+
+void GroupLookup::MaybeStartRound() {
+  if (done_ || in_flight_ != 0)
+    return;
+
+  if (rounds_ != 0) {
+    const auto closest(Closest());
+    improved_ = closest && *closest != closest_at_round_start_;
+  }
+
+  // Candidates among the closest 'group_size_' live nodes, closest first.
+  std::vector<Address> to_ask;
+  std::size_t live(0);
+  for (const auto& node : shortlist_) {
+    if (live == group_size_)
+      break;
+    if (node.second == State::failed)
+      continue;
+    ++live;
+    if (node.second == State::candidate)
+      to_ask.push_back(node.first);
+  }
+
+  if (to_ask.empty() || rounds_ == max_rounds_) {
+    done_ = true;
+    return;
+  }
+
+  // Without progress last round, ask the whole remaining group rather than just 'parallelism_'.
+  if (improved_ && to_ask.size() > parallelism_)
+    to_ask.resize(parallelism_);
+
+  const auto closest(Closest());
+  closest_at_round_start_ = closest ? *closest : Address();
+  ++rounds_;
+  for (const auto& node : to_ask) {
+    shortlist_[node] = State::in_flight;
+    ++in_flight_;
+  }
+  for (const auto& node : to_ask) {
+    ++messages_sent_;
+    send_find_group_(node);
+  }
+}
+
+const Address* GroupLookup::Closest() const {
+  for (const auto& node : shortlist_) {
+    if (node.second != State::failed)
+      return &node.first;
+  }
+  return nullptr;
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
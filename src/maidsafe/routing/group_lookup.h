@@ -0,0 +1,107 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_GROUP_LOOKUP_H_
+#define MAIDSAFE_ROUTING_GROUP_LOOKUP_H_
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <vector>
+
+#include "maidsafe/common/identity.h"
+
+#include "maidsafe/routing/routing_table.h"
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Kademlia-style iterative lookup of the close group of 'target'.  Each round sends FindGroup to
+// the 'parallelism' closest known nodes not yet asked, and the next round starts once all of those
+// have answered or the round has been timed out.  Responses are merged into the shortlist, and if a
+// round fails to find anyone closer, the next round asks every unqueried node of the closest group
+// at once.  The lookup finishes when the closest 'group_size' live nodes known have all answered,
+// or after 'max_rounds'.  The caller owns transport and timers.  Not thread-safe.
+class GroupLookup {
+ public:
+  using SendFindGroup = std::function<void(const Address& node)>;
+
+  GroupLookup(Address target, const std::vector<Address>& seeds, SendFindGroup send_find_group,
+              std::size_t parallelism = RoutingTable::Parallelism(),
+              std::size_t group_size = GroupSize, std::size_t max_rounds = 16);
+  GroupLookup(const GroupLookup&) = delete;
+  GroupLookup(GroupLookup&&) = delete;
+  ~GroupLookup() = default;
+  GroupLookup& operator=(const GroupLookup&) = delete;
+  GroupLookup& operator=(GroupLookup&&) = delete;
+
+  // Sends the first round.
+  void Start();
+  // Merges the close group reported by 'from'.  Responses from nodes not asked are merged too, as
+  // a FindGroup routed towards a node may be answered by its neighbours.
+  void HandleResponse(const Address& from, const std::vector<Address>& group);
+  // Gives up on the nodes still outstanding in the current round and moves on.
+  void HandleRoundTimeout();
+
+  bool Done() const { return done_; }
+  // The closest 'group_size' nodes which have answered, closest first.
+  std::vector<Address> Result() const;
+  const Address& Target() const { return target_; }
+  std::size_t Rounds() const { return rounds_; }
+  std::size_t MessagesSent() const { return messages_sent_; }
+
+ private:
+  enum class State { candidate, in_flight, responded, failed };
+
+  class Comparison {
+   public:
+    explicit Comparison(Address target) : target_(std::move(target)) {}
+    bool operator()(const Address& lhs, const Address& rhs) const {
+      return CloserToTarget(lhs, rhs, target_);
+    }
+
+   private:
+    Address target_;
+  };
+
+  void Merge(const Address& node);
+  void MaybeStartRound();
+  // closest live node known, if any
+  const Address* Closest() const;
+
+  const Address target_;
+  SendFindGroup send_find_group_;
+  const std::size_t parallelism_;
+  const std::size_t group_size_;
+  const std::size_t max_rounds_;
+  std::map<Address, State, Comparison> shortlist_;
+  std::size_t in_flight_;
+  Address closest_at_round_start_;
+  bool improved_;
+  bool done_;
+  std::size_t rounds_;
+  std::size_t messages_sent_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_GROUP_LOOKUP_H_
@@ -0,0 +1,75 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_MESSAGE_DISPATCH_H_
+#define MAIDSAFE_ROUTING_MESSAGE_DISPATCH_H_
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include "maidsafe/routing/messages/messages_fwd.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// A compile-time list of message types, from which tag-indexed dispatch tables are generated.
+template <typename... Messages>
+struct MessageTypeList {};
+
+namespace detail {
+
+template <typename Entry>
+void AddDispatchEntry(std::vector<Entry>& table, MessageTypeTag tag, Entry entry) {
+  const auto index(static_cast<std::size_t>(tag));
+  if (table.size() <= index)
+    table.resize(index + 1);
+  assert(!table[index] && "message type listed twice");
+  table[index] = entry;
+}
+
+}  // namespace detail
+
+// Returns a table indexed by MessageTypeTag in which the entry for each type 'M' in the list is
+// 'MakeEntry<M>::value()'.  All other entries are value-initialised (i.e. null), so 'Entry' is
+// expected to be a function or member function pointer.
+template <typename Entry, template <typename> class MakeEntry, typename... Messages>
+std::vector<Entry> MakeDispatchTable(MessageTypeList<Messages...>) {
+  std::vector<Entry> table;
+  using Expand = int[];
+  static_cast<void>(Expand{
+      0, (detail::AddDispatchEntry(table, MessageToTag<Messages>::value(),
+                                   MakeEntry<Messages>::value()),
+          0)...});
+  return table;
+}
+
+// Returns the entry for 'tag', or a null entry if the tag has none (e.g. an unknown tag received
+// from a peer running a newer version).
+template <typename Entry>
+Entry FindDispatchEntry(const std::vector<Entry>& table, MessageTypeTag tag) {
+  const auto index(static_cast<std::size_t>(tag));
+  return index < table.size() ? table[index] : Entry();
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_MESSAGE_DISPATCH_H_
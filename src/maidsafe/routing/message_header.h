@@ -19,8 +19,12 @@
 #ifndef MAIDSAFE_ROUTING_MESSAGE_HEADER_H_
 #define MAIDSAFE_ROUTING_MESSAGE_HEADER_H_
 
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <tuple>
+#include <utility>
 
 #include "boost/optional/optional.hpp"
 
@@ -28,27 +32,40 @@
 #include "maidsafe/common/crypto.h"
 #include "maidsafe/common/error.h"
 #include "maidsafe/common/rsa.h"
+#include "maidsafe/common/serialisation/serialisation.h"
 
+#include "maidsafe/routing/signature_scheme.h"
 #include "maidsafe/routing/source_address.h"
 #include "maidsafe/routing/types.h"
 #include "maidsafe/routing/utils.h"
+#include "maidsafe/routing/messages/messages_fwd.h"
 
 namespace maidsafe {
 
 namespace routing {
 
+// Version of the serialised layout of message headers and bodies.  It leads every header and must
+// be bumped with any change to either, so that a peer using another layout rejects our messages as
+// unparsable rather than misreading them.
+const uint8_t kWireVersion = 1;
+
 class MessageHeader {
  public:
   MessageHeader() = default;
   ~MessageHeader() = default;
 
   MessageHeader(DestinationAddress destination, SourceAddress source, MessageId message_id,
-                Authority our_authority, asymm::Signature signature)
+                Authority our_authority, asymm::Signature signature,
+                SignatureScheme signature_scheme = SignatureScheme::kRsa)
       : destination_(std::move(destination)),
         source_(std::move(source)),
         message_id_(message_id),
         authority_(our_authority),
-        signature_(std::move(signature)) {
+        signature_(std::move(signature)),
+        hop_limit_(),
+        deadline_(),
+        congestion_experienced_(false),
+        signature_scheme_(signature_scheme) {
     Validate();
   }
 
@@ -58,7 +75,11 @@ class MessageHeader {
         source_(std::move(source)),
         message_id_(message_id),
         authority_(our_authority),
-        signature_() {
+        signature_(),
+        hop_limit_(),
+        deadline_(),
+        congestion_experienced_(false),
+        signature_scheme_(SignatureScheme::kRsa) {
     Validate();
   }
 
@@ -67,7 +88,11 @@ class MessageHeader {
         source_(std::move(other.source_)),
         message_id_(std::move(other.message_id_)),
         authority_(std::move(other.authority_)),
-        signature_(std::move(other.signature_)) {}
+        signature_(std::move(other.signature_)),
+        hop_limit_(std::move(other.hop_limit_)),
+        deadline_(std::move(other.deadline_)),
+        congestion_experienced_(other.congestion_experienced_),
+        signature_scheme_(other.signature_scheme_) {}
 
   MessageHeader& operator=(MessageHeader&& other) MAIDSAFE_NOEXCEPT {
     destination_ = std::move(other.destination_);
@@ -75,6 +100,10 @@ class MessageHeader {
     message_id_ = std::move(other.message_id_);
     authority_ = std::move(other.authority_);
     signature_ = std::move(other.signature_);
+    hop_limit_ = std::move(other.hop_limit_);
+    deadline_ = std::move(other.deadline_);
+    congestion_experienced_ = other.congestion_experienced_;
+    signature_scheme_ = other.signature_scheme_;
     return *this;
   }
 
@@ -82,17 +111,21 @@ class MessageHeader {
   MessageHeader& operator=(const MessageHeader&) = default;
 
   bool operator==(const MessageHeader& other) const {
-    return std::tie(message_id_, destination_, source_, authority_, signature_) ==
+    return std::tie(message_id_, destination_, source_, authority_, signature_, hop_limit_,
+                    deadline_, congestion_experienced_, signature_scheme_) ==
            std::tie(other.message_id_, other.destination_, other.source_, other.authority_,
-                    other.signature_);
+                    other.signature_, other.hop_limit_, other.deadline_,
+                    other.congestion_experienced_, other.signature_scheme_);
   }
 
   bool operator!=(const MessageHeader& other) const { return !operator==(other); }
 
   bool operator<(const MessageHeader& other) const {
-    return std::tie(message_id_, destination_, source_, authority_, signature_) <
+    return std::tie(message_id_, destination_, source_, authority_, signature_, hop_limit_,
+                    deadline_, congestion_experienced_, signature_scheme_) <
            std::tie(other.message_id_, other.destination_, other.source_, other.authority_,
-                    other.signature_);
+                    other.signature_, other.hop_limit_, other.deadline_,
+                    other.congestion_experienced_, other.signature_scheme_);
   }
 
   bool operator>(const MessageHeader& other) const { return other.operator<(*this); }
@@ -101,7 +134,12 @@ class MessageHeader {
 
   template <typename Archive>
   void serialize(Archive& archive) {
-    archive(destination_, source_, message_id_, authority_, signature_);
+    uint8_t version(kWireVersion);
+    archive(version);
+    if (version != kWireVersion)
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+    archive(destination_, source_, message_id_, authority_, signature_, hop_limit_, deadline_,
+            congestion_experienced_, signature_scheme_);
   }
 
   // pair - Destination and reply to address (reply_to means this is a node not in routing tables)
@@ -114,14 +152,24 @@ class MessageHeader {
   SourceAddress Source() const { return source_; }
   uint32_t MessageId() const { return message_id_; }
   boost::optional<asymm::Signature> Signature() const { return signature_; }
+  // what Signature() was made with; the sender's key must be of the same scheme
+  SignatureScheme SignedWith() const { return signature_scheme_; }
   NodeAddress FromNode() const { return source_.node_address; }
   boost::optional<GroupAddress> FromGroup() const { return source_.group_address; }
-  Authority FromAuthority() { return authority_; }
+  Authority FromAuthority() const { return authority_; }
   bool RelayedMessage() const { return static_cast<bool>(source_.reply_to_address); }
   boost::optional<routing::ReplyToAddress> ReplyToAddress() const {
     return source_.reply_to_address;
   }
 
+  // Leading bits the sending node shares with the group it claims to speak for, or -1 if it claims
+  // no group.  Copies nothing, so is cheap enough to screen every message with.
+  int FromGroupCommonLeadingBits() const {
+    return source_.group_address
+               ? CommonLeadingBits(source_.node_address.data, source_.group_address->data)
+               : -1;
+  }
+
   Address FromAddress() const {
     if (FromGroup())
       return FromGroup()->data;
@@ -140,6 +188,38 @@ class MessageHeader {
 
   FilterType FilterValue() const { return std::make_pair(source_.node_address, message_id_); }
 
+  // Number of further hops the message may be forwarded, if the originator set a limit.
+  boost::optional<HopLimit> HopsRemaining() const { return hop_limit_; }
+  void SetHopLimit(HopLimit hop_limit) { hop_limit_ = hop_limit; }
+  // Consumes one hop.  Returns false if the message has no hops left and must not be forwarded.
+  // Messages without a hop limit can always be forwarded.
+  bool DecrementHopLimit() {
+    if (!hop_limit_)
+      return true;
+    if (*hop_limit_ == 0)
+      return false;
+    --*hop_limit_;
+    return true;
+  }
+
+  // Absolute time after which the originator no longer cares about the message.  This is carried as
+  // milliseconds since the system_clock epoch, so relies on nodes' clocks being loosely in sync.
+  void SetDeadline(std::chrono::system_clock::time_point deadline) {
+    deadline_ = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                          deadline.time_since_epoch()).count());
+  }
+  bool Expired(std::chrono::system_clock::time_point now = std::chrono::system_clock::now()) const {
+    return deadline_ &&
+           static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                     now.time_since_epoch()).count()) > *deadline_;
+  }
+
+  // Set by any node on the message's path whose queues are backed up, so that the originator can
+  // slow down before traffic has to be dropped.  Not covered by the signature, and a fixed-width
+  // field, so a forwarding node may set it with ReplaceHeader.
+  bool CongestionExperienced() const { return congestion_experienced_; }
+  void MarkCongestionExperienced() { congestion_experienced_ = true; }
+
  private:
   void Validate() const {
     if (source_.node_address->IsInitialised() ||
@@ -169,8 +249,39 @@ class MessageHeader {
   routing::MessageId message_id_;
   Authority authority_;
   boost::optional<asymm::Signature> signature_;
+  boost::optional<HopLimit> hop_limit_;
+  boost::optional<uint64_t> deadline_;
+  bool congestion_experienced_ = false;
+  SignatureScheme signature_scheme_ = SignatureScheme::kRsa;
 };
 
+// Replaces the first 'replaced_size' bytes of 'message', its serialised header and tag, with
+// 'header' and 'tag'.  Where only fixed-width fields such as the hop limit have changed the new
+// header is the same size and is copied over the old one, so a forwarded message is updated
+// without moving its body; otherwise the message is rebuilt around the body.
+inline void ReplaceHeader(const MessageHeader& header, MessageTypeTag tag,
+                          std::size_t replaced_size, SerialisedMessage& message) {
+  if (replaced_size > message.size())
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+  auto serialised_header(Serialise(header, tag));
+  if (serialised_header.size() == replaced_size) {
+    std::copy(std::begin(serialised_header), std::end(serialised_header), std::begin(message));
+    return;
+  }
+  serialised_header.insert(std::end(serialised_header),
+                           std::begin(message) + replaced_size, std::end(message));
+  message = std::move(serialised_header);
+}
+
+// Prefixes a body serialised earlier (e.g. to be signed) with 'header' and 'tag', giving the same
+// bytes as serialising all three together.
+inline SerialisedMessage SerialiseWithBody(const MessageHeader& header, MessageTypeTag tag,
+                                           const SerialisedMessage& body) {
+  auto message(Serialise(header, tag));
+  message.insert(std::end(message), std::begin(body), std::end(body));
+  return message;
+}
+
 }  // namespace routing
 
 }  // namespace maidsafe
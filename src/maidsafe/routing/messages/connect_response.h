@@ -66,11 +66,12 @@ class ConnectResponse {
     archive(requester_endpoints_, receiver_endpoints_, requester_id_, receiver_id_, receiver_fob_);
   }
 
-  EndpointPair requester_endpoints() const { return requester_endpoints_; }
-  EndpointPair receiver_endpoints() const { return receiver_endpoints_; }
-  Address requester_id() const { return requester_id_; }
-  Address receiver_id() const { return receiver_id_; }
-  passport::PublicPmid receiver_fob() const { return receiver_fob_; }
+  const EndpointPair& requester_endpoints() const { return requester_endpoints_; }
+  const EndpointPair& receiver_endpoints() const { return receiver_endpoints_; }
+  const Address& requester_id() const { return requester_id_; }
+  const Address& receiver_id() const { return receiver_id_; }
+  const passport::PublicPmid& receiver_fob() const& { return receiver_fob_; }
+  passport::PublicPmid receiver_fob() && { return std::move(receiver_fob_); }
 
  private:
   EndpointPair requester_endpoints_;
@@ -71,8 +71,9 @@ class FindGroupResponse {
     return archive;
   }
 
-  Address target_id() const { return target_id_; }
-  std::vector<passport::PublicPmid> group() const { return group_; }
+  const Address& target_id() const { return target_id_; }
+  const std::vector<passport::PublicPmid>& group() const& { return group_; }
+  std::vector<passport::PublicPmid> group() && { return std::move(group_); }
 
  private:
   Address target_id_;
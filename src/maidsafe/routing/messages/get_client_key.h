@@ -56,8 +56,8 @@ class GetClientKey {
       archive(requester_, target_id_);
   }
 
-  Identity requester() const { return requester_; }
-  Identity target_id() const { return target_id_; }
+  const Identity& requester() const { return requester_; }
+  const Identity& target_id() const { return target_id_; }
 
  private:
   Identity requester_;
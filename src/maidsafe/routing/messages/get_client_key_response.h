@@ -53,8 +53,8 @@ class GetClientKeyResponse {
       archive(address_, public_key_);
   }
 
-  Address address() const { return address_; }
-  asymm::PublicKey public_key() const { return public_key_; }
+  const Address& address() const { return address_; }
+  const asymm::PublicKey& public_key() const { return public_key_; }
 
  private:
   Address address_;
@@ -57,8 +57,8 @@ class GetData {
     archive(name_and_type_id_, requester_);
   }
 
-  Data::NameAndTypeId name_and_type_id() const { return name_and_type_id_; }
-  SourceAddress requester() const { return requester_; }
+  const Data::NameAndTypeId& name_and_type_id() const { return name_and_type_id_; }
+  const SourceAddress& requester() const { return requester_; }
 
  private:
   Data::NameAndTypeId name_and_type_id_;
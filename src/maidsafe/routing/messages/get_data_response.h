@@ -27,6 +27,8 @@
 #include "maidsafe/common/data_types/data.h"
 #include "maidsafe/common/serialisation/serialisation.h"
 
+#include "maidsafe/routing/payload_encoding.h"
+
 namespace maidsafe {
 
 namespace routing {
@@ -36,21 +38,30 @@ class GetDataResponse {
   GetDataResponse() = default;
   ~GetDataResponse() = default;
 
-  GetDataResponse(Data::NameAndTypeId name_and_type_id, SerialisedData&& data)
-      : name_and_type_id_(std::move(name_and_type_id)), data_(std::move(data)), error_() {}
+  GetDataResponse(Data::NameAndTypeId name_and_type_id, SerialisedData&& data,
+                  PayloadEncoding encoding = PayloadEncoding::kNone)
+      : name_and_type_id_(std::move(name_and_type_id)),
+        data_(std::move(data)),
+        error_(),
+        encoding_(encoding) {}
 
   GetDataResponse(Data::NameAndTypeId name_and_type_id, maidsafe_error error)
-      : name_and_type_id_(std::move(name_and_type_id)), data_(), error_(error) {}
+      : name_and_type_id_(std::move(name_and_type_id)),
+        data_(),
+        error_(error),
+        encoding_(PayloadEncoding::kNone) {}
 
   GetDataResponse(GetDataResponse&& other) MAIDSAFE_NOEXCEPT
       : name_and_type_id_(std::move(other.name_and_type_id_)),
         data_(std::move(other.data_)),
-        error_(std::move(other.error_)) {}
+        error_(std::move(other.error_)),
+        encoding_(other.encoding_) {}
 
   GetDataResponse& operator=(GetDataResponse&& other) MAIDSAFE_NOEXCEPT {
     name_and_type_id_ = std::move(other.name_and_type_id_);
     data_ = std::move(other.data_);
     error_ = std::move(other.error_);
+    encoding_ = other.encoding_;
     return *this;
   }
 
@@ -59,17 +70,21 @@ class GetDataResponse {
 
   template <typename Archive>
   void serialize(Archive& archive) {
-    archive(name_and_type_id_, data_, error_);
+    archive(name_and_type_id_, data_, error_, encoding_);
   }
 
-  Data::NameAndTypeId name_and_type_id() const { return name_and_type_id_; }
-  boost::optional<SerialisedData> data() const { return data_; }
-  boost::optional<maidsafe_error> error() const { return error_; }
+  const Data::NameAndTypeId& name_and_type_id() const { return name_and_type_id_; }
+  // as encoded by the sender; see DecodePayload
+  const boost::optional<SerialisedData>& data() const& { return data_; }
+  boost::optional<SerialisedData> data() && { return std::move(data_); }
+  const boost::optional<maidsafe_error>& error() const { return error_; }
+  PayloadEncoding encoding() const { return encoding_; }
 
  private:
   Data::NameAndTypeId name_and_type_id_;
   boost::optional<SerialisedData> data_;
   boost::optional<maidsafe_error> error_;
+  PayloadEncoding encoding_ = PayloadEncoding::kNone;
 };
 
 }  // namespace routing
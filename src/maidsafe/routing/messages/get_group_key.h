@@ -56,8 +56,8 @@ class GetGroupKey {
       archive(requester_, target_id_);
   }
 
-  SourceAddress requester() const { return requester_; }
-  Identity target_id() const { return target_id_; }
+  const SourceAddress& requester() const { return requester_; }
+  const Identity& target_id() const { return target_id_; }
 
  private:
   SourceAddress requester_;
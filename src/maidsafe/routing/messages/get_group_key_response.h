@@ -57,8 +57,9 @@ class GetGroupKeyResponse {
     archive(public_keys_, target_id_);
   }
 
-  std::map<Address, asymm::PublicKey> public_keys() const { return public_keys_; }
-  GroupAddress target_id() const { return target_id_; }
+  const std::map<Address, asymm::PublicKey>& public_keys() const& { return public_keys_; }
+  std::map<Address, asymm::PublicKey> public_keys() && { return std::move(public_keys_); }
+  const GroupAddress& target_id() const { return target_id_; }
 
  private:
   // targeted GroupAddress
@@ -33,4 +33,21 @@
 #include "maidsafe/routing/messages/put_data.h"
 #include "maidsafe/routing/messages/put_data_response.h"
 
+#include "maidsafe/routing/message_dispatch.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Every message type a node may receive.  A type added here is parsed and dispatched to its
+// HandleMessage overload (if any) without further wiring.
+using AllMessages =
+    MessageTypeList<Connect, ConnectResponse, FindGroup, FindGroupResponse, GetData,
+                    GetDataResponse, GetClientKey, GetClientKeyResponse, GetGroupKey,
+                    GetGroupKeyResponse, Post, PutData, PutDataResponse>;
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
 #endif  // MAIDSAFE_ROUTING_MESSAGES_MESSAGES_H_
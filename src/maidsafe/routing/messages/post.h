@@ -53,8 +53,9 @@ class Post {
     archive(name_and_type_id_, data_);
   }
 
-  Data::NameAndTypeId name_and_type_id() const { return name_and_type_id_; }
-  SerialisedData data() const { return data_; }
+  const Data::NameAndTypeId& name_and_type_id() const { return name_and_type_id_; }
+  const SerialisedData& data() const& { return data_; }
+  SerialisedData data() && { return std::move(data_); }
 
  private:
   Data::NameAndTypeId name_and_type_id_;
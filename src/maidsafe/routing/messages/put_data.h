@@ -23,6 +23,8 @@
 #include "maidsafe/common/types.h"
 #include "maidsafe/common/serialisation/serialisation.h"
 
+#include "maidsafe/routing/payload_encoding.h"
+
 namespace maidsafe {
 
 namespace routing {
@@ -32,14 +34,18 @@ class PutData {
   PutData() = default;
   ~PutData() = default;
 
-  PutData(DataTypeId type_id, SerialisedData data) : type_id_(type_id), data_(std::move(data)) {}
+  PutData(DataTypeId type_id, SerialisedData data,
+          PayloadEncoding encoding = PayloadEncoding::kNone)
+      : type_id_(type_id), data_(std::move(data)), encoding_(encoding) {}
 
   PutData(PutData&& other) MAIDSAFE_NOEXCEPT : type_id_(std::move(other.type_id_)),
-                                               data_(std::move(other.data_)) {}
+                                               data_(std::move(other.data_)),
+                                               encoding_(other.encoding_) {}
 
   PutData& operator=(PutData&& other) MAIDSAFE_NOEXCEPT {
     type_id_ = std::move(other.type_id_);
     data_ = std::move(other.data_);
+    encoding_ = other.encoding_;
     return *this;
   }
 
@@ -48,15 +54,19 @@ class PutData {
 
   template <typename Archive>
   void serialize(Archive& archive) {
-    archive(type_id_, data_);
+    archive(type_id_, data_, encoding_);
   }
 
   DataTypeId type_id() const { return type_id_; }
-  SerialisedData data() const { return data_; }
+  // as encoded by the sender; see DecodePayload
+  const SerialisedData& data() const& { return data_; }
+  SerialisedData data() && { return std::move(data_); }
+  PayloadEncoding encoding() const { return encoding_; }
 
  private:
   DataTypeId type_id_;
   SerialisedData data_;
+  PayloadEncoding encoding_ = PayloadEncoding::kNone;
 };
 
 }  // namespace routing
@@ -56,8 +56,9 @@ class PutDataResponse {
   }
 
   DataTypeId type_id() const { return type_id_; }
-  SerialisedData data() const { return data_; }
-  maidsafe_error error() const { return error_; }
+  const SerialisedData& data() const& { return data_; }
+  SerialisedData data() && { return std::move(data_); }
+  const maidsafe_error& error() const { return error_; }
 
  private:
   DataTypeId type_id_;
@@ -72,6 +72,19 @@ TEST(GetDataResponseTest, BEH_SerialiseParse) {
   EXPECT_EQ(get_data_rsp_before.data()->size(), get_data_rsp_after.data()->size());
 }
 
+TEST(GetDataResponseTest, BEH_MoveOutData) {
+  auto get_data_rsp(GenerateInstance());
+  ASSERT_TRUE(!!get_data_rsp.data());
+  const auto expected(*get_data_rsp.data());
+  const auto* const payload(get_data_rsp.data()->data());
+
+  // moving the payload out must hand over the buffer rather than copying it
+  auto moved_data(std::move(get_data_rsp).data());
+  ASSERT_TRUE(!!moved_data);
+  EXPECT_EQ(expected, *moved_data);
+  EXPECT_EQ(payload, moved_data->data());
+}
+
 }  // namespace test
 
 }  // namespace routing
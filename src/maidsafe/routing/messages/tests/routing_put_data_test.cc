@@ -69,6 +69,33 @@ TEST(PutDataTest, BEH_SerialiseParse) {
   EXPECT_EQ(put_data_before.data(), put_data_after.data());
 }
 
+TEST(PutDataTest, BEH_SerialiseParseEncoding) {
+  const PutData before{DataTypeId{RandomUint32()}, RandomBytes(100), PayloadEncoding::kCompressed};
+  EXPECT_EQ(PayloadEncoding::kNone, GenerateInstance().encoding());
+
+  auto serialised(Serialise(GetRandomMessageHeader(), MessageToTag<PutData>::value(), before));
+  InputVectorStream binary_input_stream{serialised};
+  MessageHeader header;
+  MessageTypeTag tag;
+  Parse(binary_input_stream, header, tag);
+  PutData after;
+  Parse(binary_input_stream, after);
+
+  EXPECT_EQ(PayloadEncoding::kCompressed, after.encoding());
+  EXPECT_EQ(before.data(), after.data());
+}
+
+TEST(PutDataTest, BEH_MoveOutData) {
+  auto put_data(GenerateInstance());
+  const auto expected(put_data.data());
+  const auto* const payload(put_data.data().data());
+
+  // moving the payload out must hand over the buffer rather than copying it
+  auto moved_data(std::move(put_data).data());
+  EXPECT_EQ(expected, moved_data);
+  EXPECT_EQ(payload, moved_data.data());
+}
+
 }  // namespace test
 
 }  // namespace routing
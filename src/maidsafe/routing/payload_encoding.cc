@@ -0,0 +1,141 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/payload_encoding.h"
+
+#include <array>
+#include <cmath>
+#include <string>
+
+#include "cryptopp/gzip.h"
+
+#include "maidsafe/common/crypto.h"
+#include "maidsafe/common/error.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace {
+
+// Fastest gzip level: payloads are compressed on the send path.
+const int kCompressionLevel = 1;
+// Bytes inspected by LooksCompressible, taken in 'kSampleRuns' runs spread across the data.  Less
+// data than 'kMinSampleBytes' is too little to judge, or to be worth compressing.
+const size_t kSampleBytes = 4096;
+const size_t kSampleRuns = 8;
+const size_t kMinSampleBytes = 512;
+// Bits of entropy per byte above which data isn't worth compressing.
+const double kMaxCompressibleEntropy = 7.5;
+
+// Collects decompressed bytes, throwing once there are more than 'max_bytes' of them.
+class BoundedSink : public CryptoPP::Bufferless<CryptoPP::Sink> {
+ public:
+  BoundedSink(SerialisedData& output, size_t max_bytes) : output_(output), max_bytes_(max_bytes) {}
+
+  size_t Put2(const unsigned char* input, size_t length, int /*message_end*/,
+              bool /*blocking*/) override {
+    if (length > max_bytes_ - output_.size())
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+    output_.insert(std::end(output_), input, input + length);
+    return 0;
+  }
+
+ private:
+  SerialisedData& output_;
+  const size_t max_bytes_;
+};
+
+// crypto::Uncompress, but giving up once the output passes 'max_bytes'
+SerialisedData Gunzip(const SerialisedData& data, size_t max_bytes) {
+  SerialisedData output;
+  try {
+    CryptoPP::Gunzip gunzip(new BoundedSink(output, max_bytes));
+    gunzip.Put(data.data(), data.size());
+    gunzip.MessageEnd();
+  } catch (const CryptoPP::Exception&) {
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+  }
+  return output;
+}
+
+}  // unnamed namespace
+
+bool LooksCompressible(const SerialisedData& data) {
+  if (data.size() < kMinSampleBytes)
+    return false;
+  std::array<size_t, 256> counts{};
+  size_t sampled(0);
+  if (data.size() <= kSampleBytes) {
+    for (auto value : data)
+      ++counts[value];
+    sampled = data.size();
+  } else {
+    const size_t run(kSampleBytes / kSampleRuns);
+    const size_t stride((data.size() - run) / (kSampleRuns - 1));
+    for (size_t i(0); i < kSampleRuns; ++i) {
+      for (size_t j(i * stride); j < i * stride + run; ++j)
+        ++counts[data[j]];
+    }
+    sampled = run * kSampleRuns;
+  }
+  double entropy(0.0);
+  size_t distinct(0);
+  for (auto count : counts) {
+    if (count == 0)
+      continue;
+    ++distinct;
+    const double p(static_cast<double>(count) / sampled);
+    entropy -= p * std::log2(p);
+  }
+  // A sample underestimates the entropy of what it is drawn from; this is the Miller-Madow
+  // correction for it.
+  entropy += static_cast<double>(distinct - 1) / (2.0 * sampled * std::log(2.0));
+  return entropy < kMaxCompressibleEntropy;
+}
+
+PayloadEncoding EncodePayload(SerialisedData& data, size_t min_bytes) {
+  if (min_bytes == 0 || data.size() < min_bytes || !LooksCompressible(data))
+    return PayloadEncoding::kNone;
+  const auto compressed(
+      crypto::Compress(crypto::UncompressedText(NonEmptyString(data)), kCompressionLevel));
+  const auto& bytes(compressed.data.string());
+  if (bytes.size() >= data.size())
+    return PayloadEncoding::kNone;
+  data.assign(std::begin(bytes), std::end(bytes));
+  return PayloadEncoding::kCompressed;
+}
+
+SerialisedData DecodePayload(PayloadEncoding encoding, SerialisedData data, size_t max_bytes) {
+  switch (encoding) {
+    case PayloadEncoding::kNone:
+      if (data.size() > max_bytes)
+        BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+      return data;
+    case PayloadEncoding::kCompressed:
+      if (data.empty())
+        BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+      return Gunzip(data, max_bytes);
+    default:
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+  }
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
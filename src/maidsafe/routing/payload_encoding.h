@@ -0,0 +1,59 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_PAYLOAD_ENCODING_H_
+#define MAIDSAFE_ROUTING_PAYLOAD_ENCODING_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "maidsafe/common/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// How the data carried in a PutData or GetDataResponse is encoded.  Only the node the message is
+// for decodes it; forwarding nodes pass the bytes on as they are.  Every encoding is part of the
+// message layout covered by kWireVersion, so any node which can parse the message can decode it.
+enum class PayloadEncoding : uint8_t { kNone = 0, kCompressed = 1 };
+
+// A payload kept as it arrived, to be decoded only where it is used.
+struct EncodedPayload {
+  PayloadEncoding encoding;
+  SerialisedData data;
+};
+
+// Estimates from a sample of 'data' whether compressing it is worth trying.  Data which is already
+// compressed or encrypted has close to eight bits of entropy per byte and is left alone.
+bool LooksCompressible(const SerialisedData& data);
+
+// Compresses 'data' in place if it is at least 'min_bytes', looks compressible and comes out
+// smaller, returning the encoding it is left in.  A 'min_bytes' of 0 disables compression.
+PayloadEncoding EncodePayload(SerialisedData& data, size_t min_bytes);
+
+// Reverses EncodePayload.  Throws CommonErrors::parsing_error if the encoding is unknown, or 'data'
+// doesn't decode or would decode to more than 'max_bytes'.  Decoding stops as soon as the limit is
+// passed, so a small payload can't be made to inflate without bound.
+SerialisedData DecodePayload(PayloadEncoding encoding, SerialisedData data, size_t max_bytes);
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_PAYLOAD_ENCODING_H_
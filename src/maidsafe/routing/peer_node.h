@@ -19,6 +19,7 @@
 #ifndef MAIDSAFE_ROUTING_PEER_NODE_H_
 #define MAIDSAFE_ROUTING_PEER_NODE_H_
 
+#include <atomic>
 #include <memory>
 
 #include "maidsafe/common/convert.h"
@@ -26,6 +27,7 @@
 #include "maidsafe/passport/types.h"
 
 #include "maidsafe/routing/node_info.h"
+#include "maidsafe/routing/shared_memory_ring.h"
 #include "maidsafe/routing/types.h"
 
 namespace maidsafe {
@@ -41,29 +43,50 @@ class PeerNode {
       : node_info_(std::move(other.node_info_)),
         receive_buffer_(std::move(other.receive_buffer_)),
         socket_(std::move(other.socket_)),
+        pending_send_bytes_(std::move(other.pending_send_bytes_)),
+        shared_memory_(std::move(other.shared_memory_)),
         destroy_indicator_(std::move(other.destroy_indicator_)) {}
 
   PeerNode& operator=(PeerNode&& other) {
     node_info_ = std::move(other.node_info_);
     receive_buffer_ = std::move(other.receive_buffer_);
     socket_ = std::move(other.socket_);
+    pending_send_bytes_ = std::move(other.pending_send_bytes_);
+    shared_memory_ = std::move(other.shared_memory_);
     destroy_indicator_ = std::move(other.destroy_indicator_);
     return *this;
   }
 
-  PeerNode(NodeInfo node_info, std::shared_ptr<crux::socket> socket)
+  PeerNode(NodeInfo node_info, std::shared_ptr<crux::socket> socket,
+           size_t max_message_size = MaxMessageSize())
       : node_info_(std::move(node_info)),
-        receive_buffer_(std::make_shared<SerialisedMessage>(MaxMessageSize())),
+        receive_buffer_(std::make_shared<SerialisedMessage>(max_message_size)),
         socket_(std::move(socket)),
+        pending_send_bytes_(std::make_shared<std::atomic<size_t>>(0)),
+        shared_memory_(),
         destroy_indicator_(new boost::none_t) {}
 
   template <typename Message, typename Handler>
   void Send(Message msg, const Handler& handler) {
-    auto msg_ptr = std::make_shared<Message>(std::move(msg));
+    Send(std::make_shared<const Message>(std::move(msg)), handler);
+  }
+
+  // Allows one serialised message to be shared by all the peers it is sent to (e.g. when
+  // forwarding) rather than each send taking its own copy.
+  template <typename Message, typename Handler>
+  void Send(std::shared_ptr<const Message> msg_ptr, const Handler& handler) {
+    if (shared_memory_ && shared_memory_->TrySend(*msg_ptr)) {
+      shared_memory_->Post([handler] { handler(std::error_code()); });
+      return;
+    }
     auto guard = DestroyGuard();
+    auto pending = pending_send_bytes_;
+    *pending += msg_ptr->size();
 
     socket_->async_send(boost::asio::buffer(*msg_ptr),
-                        [this, msg_ptr, handler, guard](boost::system::error_code error, size_t) {
+                        [this, msg_ptr, handler, guard, pending](boost::system::error_code error,
+                                                                 size_t) {
+      *pending -= msg_ptr->size();
       if (!guard.lock()) {
         // This object was destroyed.
         return handler(asio::error::operation_aborted);
@@ -104,16 +127,27 @@ class PeerNode {
 
   const Address& id() const { return node_info_.id; }
   const NodeInfo& node_info() const { return node_info_; }
+  // Sends to this peer go through 'channel' once the peer has attached to it and where it has
+  // room, rather than by UDP.
+  void UseSharedMemory(std::unique_ptr<SharedMemoryChannel> channel) {
+    shared_memory_ = std::move(channel);
+  }
+  bool UsingSharedMemory() const { return static_cast<bool>(shared_memory_); }
+  // Bytes handed to Send whose UDP sends have not yet completed.
+  size_t PendingSendBytes() const { return *pending_send_bytes_; }
 
   std::weak_ptr<boost::none_t> DestroyGuard() { return destroy_indicator_; }
 
-  // TODO(Team): This should be in some global scope config file or something.
-  static size_t MaxMessageSize() { return 1048576; }
+  // Default receive buffer size; see RoutingConfig::max_message_size.
+  static size_t MaxMessageSize() { return DefaultMaxMessageSize; }
 
  private:
   NodeInfo node_info_;
   std::shared_ptr<SerialisedMessage> receive_buffer_;
   std::shared_ptr<crux::socket> socket_;  // TODO(Team): ditch shared_ptr
+  // shared with outstanding sends, which may complete after this object is moved
+  std::shared_ptr<std::atomic<size_t>> pending_send_bytes_;
+  std::unique_ptr<SharedMemoryChannel> shared_memory_;
   std::shared_ptr<boost::none_t> destroy_indicator_;
 };
 
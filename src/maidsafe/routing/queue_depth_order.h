@@ -0,0 +1,74 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_QUEUE_DEPTH_ORDER_H_
+#define MAIDSAFE_ROUTING_QUEUE_DEPTH_ORDER_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Reorders next hops, given closest to 'target' first, so that a peer with at least
+// 'congested_bytes' waiting to be sent goes behind its uncongested equivalents.  Peers are
+// equivalent where they share the same number of leading bits with the target, i.e. sending to
+// either makes the same XOR progress; peers are never moved past one making more progress.  Within
+// each run uncongested peers keep their XOR order and congested ones are ordered by queue depth.
+// 'pending_bytes' maps a candidate Address to the bytes queued to it.
+template <typename PendingBytes>
+void OrderByQueueDepth(const Address& target, std::vector<Address>& candidates,
+                       size_t congested_bytes, const PendingBytes& pending_bytes) {
+  // Sorting on leading bits shared with the target keeps the XOR order between runs, as closer
+  // peers never share fewer bits.
+  struct Keyed {
+    int common_leading_bits;
+    size_t congestion;
+    Address id;
+  };
+  std::vector<Keyed> keyed;
+  keyed.reserve(candidates.size());
+  bool any_congested(false);
+  for (auto& candidate : candidates) {
+    const size_t pending(pending_bytes(candidate));
+    const bool congested(pending >= congested_bytes);
+    any_congested |= congested;
+    keyed.push_back(
+        Keyed{CommonLeadingBits(candidate, target), congested ? pending : 0, std::move(candidate)});
+  }
+  if (any_congested) {
+    std::stable_sort(std::begin(keyed), std::end(keyed), [](const Keyed& lhs, const Keyed& rhs) {
+      return lhs.common_leading_bits != rhs.common_leading_bits
+                 ? lhs.common_leading_bits > rhs.common_leading_bits
+                 : lhs.congestion < rhs.congestion;
+    });
+  }
+  std::transform(std::begin(keyed), std::end(keyed), std::begin(candidates),
+                 [](Keyed& entry) { return std::move(entry.id); });
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_QUEUE_DEPTH_ORDER_H_
@@ -0,0 +1,78 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/republish_scheduler.h"
+
+#include <limits>
+#include <utility>
+
+#include "maidsafe/common/utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace {
+
+// uniform in [0, 1]
+double RandomFraction() {
+  return static_cast<double>(RandomUint32()) / std::numeric_limits<uint32_t>::max();
+}
+
+}  // unnamed namespace
+
+RepublishScheduler::RepublishScheduler(Republish republish, Clock::duration interval,
+                                       double jitter, Clock::duration piggyback_window,
+                                       Clock::time_point now)
+    : republish_(std::move(republish)),
+      interval_(interval),
+      jitter_(jitter),
+      piggyback_window_(piggyback_window),
+      due_(now + std::chrono::duration_cast<Clock::duration>(interval * RandomFraction())),
+      republished_(0),
+      piggybacked_(0) {}
+
+bool RepublishScheduler::OnTimer(Clock::time_point now) {
+  if (now < due_)
+    return false;
+  Publish(now);
+  return true;
+}
+
+bool RepublishScheduler::OnTrafficToGroup(Clock::time_point now) {
+  if (due_ - now > piggyback_window_)
+    return false;
+  ++piggybacked_;
+  Publish(now);
+  return true;
+}
+
+RepublishScheduler::Clock::duration RepublishScheduler::NextPeriod() const {
+  return std::chrono::duration_cast<Clock::duration>(interval_ *
+                                                     (1.0 - jitter_ * RandomFraction()));
+}
+
+void RepublishScheduler::Publish(Clock::time_point now) {
+  ++republished_;
+  due_ = now + NextPeriod();
+  republish_();
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,79 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_REPUBLISH_SCHEDULER_H_
+#define MAIDSAFE_ROUTING_REPUBLISH_SCHEDULER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+namespace maidsafe {
+
+namespace routing {
+
+// Decides when our PublicPmid is republished to the group at our address, which only caches it.
+// Each republish falls due a random time between 'interval * (1 - jitter)' and 'interval' after
+// the previous one (the first within 'interval' of starting), so nodes started together drift
+// apart rather than republishing in step.  A republish due within 'piggyback_window' is sent
+// early alongside other traffic to the group.  The caller owns the timer, waking it at Due().
+// Not thread-safe.
+class RepublishScheduler {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using Republish = std::function<void()>;
+
+  RepublishScheduler(Republish republish, Clock::duration interval = std::chrono::minutes(8),
+                     double jitter = 0.25,
+                     Clock::duration piggyback_window = std::chrono::minutes(2),
+                     Clock::time_point now = Clock::now());
+  RepublishScheduler(const RepublishScheduler&) = delete;
+  RepublishScheduler(RepublishScheduler&&) = delete;
+  ~RepublishScheduler() = default;
+  RepublishScheduler& operator=(const RepublishScheduler&) = delete;
+  RepublishScheduler& operator=(RepublishScheduler&&) = delete;
+
+  Clock::time_point Due() const { return due_; }
+  // Republishes if the republish has fallen due.  Returns true if it republished.
+  bool OnTimer(Clock::time_point now = Clock::now());
+  // Republishes now if due within the piggyback window, as we are about to send to the group
+  // anyway.  Returns true if it republished.
+  bool OnTrafficToGroup(Clock::time_point now = Clock::now());
+
+  uint64_t Republished() const { return republished_; }
+  uint64_t Piggybacked() const { return piggybacked_; }
+
+ private:
+  // the time from one republish to the next, drawn afresh each time
+  Clock::duration NextPeriod() const;
+  void Publish(Clock::time_point now);
+
+  Republish republish_;
+  const Clock::duration interval_;
+  const double jitter_;
+  const Clock::duration piggyback_window_;
+  Clock::time_point due_;
+  uint64_t republished_;
+  uint64_t piggybacked_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_REPUBLISH_SCHEDULER_H_
@@ -0,0 +1,93 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/request_coalescer.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace maidsafe {
+
+namespace routing {
+
+RequestCoalescer::RequestCoalescer(Clock::duration deadline, std::size_t max_names,
+                                   std::size_t max_waiters, std::size_t quorum)
+    : deadline_(deadline),
+      max_names_(max_names),
+      max_waiters_(max_waiters),
+      quorum_(quorum),
+      in_flight_(),
+      coalesced_(0),
+      expired_(0) {}
+
+bool RequestCoalescer::Join(const Data::NameAndTypeId& name, Waiter waiter,
+                            Clock::time_point now) {
+  auto found(in_flight_.find(name));
+  if (found == std::end(in_flight_)) {
+    if (in_flight_.size() < max_names_)
+      in_flight_.emplace(name, InFlight{now + deadline_, std::vector<Waiter>(),
+                                        std::vector<Address>()});
+    return false;
+  }
+  // past its deadline, the request in flight is no longer worth waiting for; requests already
+  // held behind it are left for Expire
+  if (found->second.deadline < now || found->second.waiters.size() >= max_waiters_ ||
+      !found->second.responders.empty())
+    return false;
+  found->second.waiters.push_back(std::move(waiter));
+  ++coalesced_;
+  return true;
+}
+
+std::vector<RequestCoalescer::Reply> RequestCoalescer::Answer(const Data::NameAndTypeId& name,
+                                                              const Address& responder) {
+  std::vector<Reply> replies;
+  auto found(in_flight_.find(name));
+  if (found == std::end(in_flight_))
+    return replies;
+  auto& responders(found->second.responders);
+  if (std::find(std::begin(responders), std::end(responders), responder) != std::end(responders))
+    return replies;
+  responders.push_back(responder);
+  replies.reserve(found->second.waiters.size());
+  for (const auto& waiter : found->second.waiters)
+    replies.push_back(Reply{waiter.from_peer, waiter.reply_to, waiter.message_id});
+  if (responders.size() >= quorum_)
+    in_flight_.erase(found);
+  return replies;
+}
+
+std::vector<std::pair<Data::NameAndTypeId, RequestCoalescer::Waiter>> RequestCoalescer::Expire(
+    Clock::time_point now) {
+  std::vector<std::pair<Data::NameAndTypeId, Waiter>> waiters;
+  for (auto itr(std::begin(in_flight_)); itr != std::end(in_flight_);) {
+    if (itr->second.deadline < now) {
+      for (auto& waiter : itr->second.waiters)
+        waiters.emplace_back(itr->first, std::move(waiter));
+      itr = in_flight_.erase(itr);
+    } else {
+      ++itr;
+    }
+  }
+  expired_ += waiters.size();
+  return waiters;
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,115 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_REQUEST_COALESCER_H_
+#define MAIDSAFE_ROUTING_REQUEST_COALESCER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "maidsafe/common/data_types/data.h"
+
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Holds GetData requests passing through us for data already being fetched through us, so that
+// during a flash crowd only one request per name goes on towards the data's group and its
+// responses are copied back to each requester held here.  Responses are routed towards their
+// requester, not back along the request's path, so the caller must only pass requests whose
+// responses come back through us (those from clients we relay for).  The first request for a name
+// is forwarded as usual and starts a window of 'deadline'.  Requests joining it are held, and each
+// is sent a copy of every response from a distinct group member until 'quorum' have been passed
+// on, as that is what a requester needs to accept the data.  Held requests still short of a
+// quorum when the window closes are returned by Expire to be forwarded after all.  At most
+// 'max_names' names are tracked and 'max_waiters' requests held per name; requests beyond either
+// limit are simply forwarded.  Not thread-safe.
+class RequestCoalescer {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Waiter {
+    // the peer the request came from, which the response is sent back to
+    Address from_peer;
+    // where and under which id the requester expects the response
+    DestinationAddress reply_to;
+    MessageId message_id;
+    // the request as it would have been forwarded
+    SerialisedMessage request;
+  };
+
+  // what is needed to address a copy of a response to a held request, which itself stays held
+  struct Reply {
+    Address from_peer;
+    DestinationAddress reply_to;
+    MessageId message_id;
+  };
+
+  explicit RequestCoalescer(Clock::duration deadline = std::chrono::seconds(2),
+                            std::size_t max_names = 1024, std::size_t max_waiters = 64,
+                            std::size_t quorum = QuorumSize);
+  RequestCoalescer(const RequestCoalescer&) = delete;
+  RequestCoalescer(RequestCoalescer&&) = delete;
+  ~RequestCoalescer() = default;
+  RequestCoalescer& operator=(const RequestCoalescer&) = delete;
+  RequestCoalescer& operator=(RequestCoalescer&&) = delete;
+
+  // Returns true if 'waiter' has been held behind a request for 'name' already in flight.  Returns
+  // false if the caller should forward the request itself, in which case it may become the request
+  // in flight for 'name'.  Once responses for 'name' have started passing us, later requests are
+  // forwarded, as they would miss the copies already passed on.
+  bool Join(const Data::NameAndTypeId& name, Waiter waiter, Clock::time_point now = Clock::now());
+  // Returns where to send copies of a response from 'responder' to the requests held for 'name';
+  // none if a response from 'responder' has already been passed on.  Once responses from 'quorum'
+  // distinct responders have been passed on the requests are no longer held.
+  std::vector<Reply> Answer(const Data::NameAndTypeId& name, const Address& responder);
+  // Removes and returns the requests held behind any request in flight for longer than 'deadline',
+  // each with the name it is for.
+  std::vector<std::pair<Data::NameAndTypeId, Waiter>> Expire(Clock::time_point now = Clock::now());
+
+  std::size_t size() const { return in_flight_.size(); }
+  uint64_t Coalesced() const { return coalesced_; }
+  uint64_t Expired() const { return expired_; }
+
+ private:
+  struct InFlight {
+    Clock::time_point deadline;
+    std::vector<Waiter> waiters;
+    // those whose responses have been passed on to the waiters
+    std::vector<Address> responders;
+  };
+
+  const Clock::duration deadline_;
+  const std::size_t max_names_;
+  const std::size_t max_waiters_;
+  const std::size_t quorum_;
+  std::map<Data::NameAndTypeId, InFlight> in_flight_;
+  uint64_t coalesced_;
+  uint64_t expired_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_REQUEST_COALESCER_H_
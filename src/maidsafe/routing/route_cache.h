@@ -0,0 +1,129 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_ROUTE_CACHE_H_
+#define MAIDSAFE_ROUTING_ROUTE_CACHE_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Routing decisions for recently seen destinations, keyed by the first 'kPrefixBits' bits of the
+// destination so that a burst of traffic to one group costs a single computation.  A decision may
+// only be cached where it holds for every destination sharing that prefix, which is for the caller
+// to ensure.  Entries are tagged with the membership epoch they were computed in and a lookup in a
+// later epoch empties the cache.  At most 'capacity' prefixes are held, the oldest being dropped
+// first.  Not thread-safe.
+template <typename ValueType>
+class RouteCache {
+ public:
+  static const int kPrefixBits = 64;
+
+  explicit RouteCache(size_t capacity = 128)
+      : capacity_(capacity), epoch_(0), entries_(), oldest_first_(), next_(0), hits_(0),
+        misses_(0) {
+    entries_.reserve(capacity_);
+    oldest_first_.reserve(capacity_);
+  }
+
+  RouteCache(const RouteCache&) = delete;
+  RouteCache(RouteCache&&) = delete;
+  ~RouteCache() = default;
+  RouteCache& operator=(const RouteCache&) = delete;
+  RouteCache& operator=(RouteCache&&) = delete;
+
+  // Returns the entry for 'destination's prefix computed in 'epoch', or nullptr.  The pointer is
+  // invalidated by the next call to Get or Add.
+  const ValueType* Get(const Address& destination, uint64_t epoch) {
+    if (MoveToEpoch(epoch)) {
+      auto found(entries_.find(Prefix(destination)));
+      if (found != std::end(entries_)) {
+        ++hits_;
+        return &found->second;
+      }
+    }
+    ++misses_;
+    return nullptr;
+  }
+
+  // Entries computed in an epoch which has since passed are ignored.
+  void Add(const Address& destination, uint64_t epoch, ValueType value) {
+    if (capacity_ == 0 || !MoveToEpoch(epoch))
+      return;
+    const auto prefix(Prefix(destination));
+    if (!entries_.emplace(prefix, std::move(value)).second)
+      return;
+    if (oldest_first_.size() < capacity_) {
+      oldest_first_.push_back(prefix);
+    } else {
+      entries_.erase(oldest_first_[next_]);
+      oldest_first_[next_] = prefix;
+    }
+    next_ = (next_ + 1) % capacity_;
+  }
+
+  uint64_t Hits() const { return hits_; }
+  uint64_t Misses() const { return misses_; }
+
+  static uint64_t Prefix(const Address& destination) {
+    const auto& bytes(destination.string());
+    uint64_t prefix(0);
+    for (int i(0); i != kPrefixBits / 8; ++i)
+      prefix = (prefix << 8) | static_cast<unsigned char>(bytes[i]);
+    return prefix;
+  }
+
+ private:
+  // empties the cache if 'epoch' is newer than its entries; returns false if it's older
+  bool MoveToEpoch(uint64_t epoch) {
+    if (epoch < epoch_)
+      return false;
+    if (epoch > epoch_) {
+      entries_.clear();
+      oldest_first_.clear();
+      next_ = 0;
+      epoch_ = epoch;
+    }
+    return true;
+  }
+
+  const size_t capacity_;
+  uint64_t epoch_;
+  std::unordered_map<uint64_t, ValueType> entries_;
+  std::vector<uint64_t> oldest_first_;
+  size_t next_;
+  uint64_t hits_;
+  uint64_t misses_;
+};
+
+template <typename ValueType>
+const int RouteCache<ValueType>::kPrefixBits;
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_ROUTE_CACHE_H_
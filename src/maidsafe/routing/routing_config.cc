@@ -0,0 +1,69 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/routing_config.h"
+
+#include "maidsafe/common/error.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace {
+
+// Generous upper bounds; beyond these a value is much more likely a typo than a deliberate choice.
+const unsigned kMaxThreadCount = 1024;
+const size_t kMaxMessageSizeLimit = 64 * 1024 * 1024;
+// Must hold a serialised PublicPmid.
+const size_t kMinExchangeBufferSize = 4096;
+const size_t kMinSharedMemoryRingBytes = 64 * 1024;
+const unsigned kMaxPendingAcceptsPerPort = 256;
+
+}  // unnamed namespace
+
+void RoutingConfig::Validate() const {
+  // Handlers on the crux service share state without a strand, so must all run on one thread.
+  if (crux_thread_count != 1 || worker_thread_count == 0 || worker_thread_count > kMaxThreadCount)
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+  if (filter_time_to_live <= std::chrono::seconds(0) ||
+      cache_time_to_live <= std::chrono::seconds(0) ||
+      sentinel_time_to_live <= std::chrono::seconds(0))
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+  if (negative_cache_time_to_live <= std::chrono::seconds(0) ||
+      negative_cache_time_to_live > cache_time_to_live)
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+  if (max_message_size == 0 || max_message_size > kMaxMessageSizeLimit)
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+  if (exchange_buffer_size < kMinExchangeBufferSize || exchange_buffer_size > max_message_size)
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+  if (hop_limit == 0 || request_timeout <= std::chrono::seconds(0) || congested_peer_bytes == 0)
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+  if (pending_accepts_per_port == 0 || pending_accepts_per_port > kMaxPendingAcceptsPerPort)
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+  if (shared_memory_ring_bytes != 0 && (shared_memory_ring_bytes < kMinSharedMemoryRingBytes ||
+                                        shared_memory_ring_bytes > kMaxMessageSizeLimit))
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+  if (lookup_round_timeout <= std::chrono::milliseconds(0) ||
+      bucket_refresh_interval <= std::chrono::seconds(0) ||
+      key_republish_interval <= std::chrono::seconds(0))
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -38,7 +38,13 @@ void Validate(const Address& id) {
 }  // unnamed namespace
 
 RoutingTable::RoutingTable(Address our_id)
-    : our_id_(std::move(our_id)), comparison_(our_id_), mutex_(), nodes_() {
+    : our_id_(std::move(our_id)),
+      comparison_(our_id_),
+      mutex_(),
+      nodes_(),
+      epoch_(0),
+      prefixes_distinct_(true),
+      route_cache_() {
   assert(our_id_.IsInitialised());
 }
 
@@ -72,6 +78,7 @@ std::pair<bool, boost::optional<NodeInfo>> RoutingTable::AddNode(NodeInfo their_
       std::advance(iter, std::distance<decltype(removal_candidate)>(iter, removal_candidate));
       auto candidate = *removal_candidate;
       nodes_.erase(iter);
+      MembershipChanged();
       return {true, candidate};
     }
   }
@@ -112,9 +119,13 @@ bool RoutingTable::CheckNode(const Address& their_id) const {
 void RoutingTable::DropNode(const Address& node_to_drop) {
   Validate(node_to_drop);
   std::lock_guard<std::mutex> lock(mutex_);
-  nodes_.erase(remove_if(std::begin(nodes_), std::end(nodes_),
-                         [&node_to_drop](const NodeInfo& node) { return node.id == node_to_drop; }),
-               std::end(nodes_));
+  auto removed(std::remove_if(
+      std::begin(nodes_), std::end(nodes_),
+      [&node_to_drop](const NodeInfo& node) { return node.id == node_to_drop; }));
+  if (removed == std::end(nodes_))
+    return;
+  nodes_.erase(removed, std::end(nodes_));
+  MembershipChanged();
 }
 
 std::vector<NodeInfo> RoutingTable::TargetNodes(const Address& target) const {
@@ -126,6 +137,8 @@ std::vector<NodeInfo> RoutingTable::TargetNodes(const Address& target) const {
   std::vector<NodeInfo> result;
   {
     std::lock_guard<std::mutex> lock(mutex_);
+    if (const auto cached = route_cache_.Get(target, epoch_))
+      return *cached;
     auto parallelism = std::min(Parallelism(), nodes_.size());
     for (auto itr = std::begin(nodes_); itr != std::end(nodes_); ++itr, ++iterations) {
       // close group is first 'GroupSize' contacts
@@ -152,6 +165,8 @@ std::vector<NodeInfo> RoutingTable::TargetNodes(const Address& target) const {
         result.push_back(*(*closest_itr));
       }
     }
+    if (prefixes_distinct_)
+      route_cache_.Add(target, epoch_, result);
   }
   return result;
 }
@@ -183,6 +198,21 @@ size_t RoutingTable::Size() const {
   return nodes_.size();
 }
 
+uint64_t RoutingTable::Epoch() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return epoch_;
+}
+
+uint64_t RoutingTable::RouteCacheHits() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return route_cache_.Hits();
+}
+
+uint64_t RoutingTable::RouteCacheMisses() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return route_cache_.Misses();
+}
+
 // bucket 511 is us, 0 is furthest bucket (should fill first)
 int32_t RoutingTable::BucketIndex(const Address& address) const {
   assert(address != our_id_);
@@ -203,6 +233,21 @@ bool RoutingTable::NewNodeIsBetterThanExisting(
 void RoutingTable::PushBackThenSort(NodeInfo their_info) {
   nodes_.push_back(std::move(their_info));
   std::sort(std::begin(nodes_), std::end(nodes_), comparison_);
+  MembershipChanged();
+}
+
+// Two contacts differing within the first 'kPrefixBits' bits are ordered by their distance from a
+// target using only those bits of the target, so while all contacts' prefixes differ, every target
+// sharing a prefix gets the same TargetNodes result.
+void RoutingTable::MembershipChanged() {
+  ++epoch_;
+  std::vector<uint64_t> prefixes;
+  prefixes.reserve(nodes_.size());
+  for (const auto& node : nodes_)
+    prefixes.push_back(RouteCache<std::vector<NodeInfo>>::Prefix(node.id));
+  std::sort(std::begin(prefixes), std::end(prefixes));
+  prefixes_distinct_ =
+      std::adjacent_find(std::begin(prefixes), std::end(prefixes)) == std::end(prefixes);
 }
 
 std::vector<NodeInfo>::const_iterator RoutingTable::FindCandidateForRemoval() const {
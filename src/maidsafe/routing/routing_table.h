@@ -29,6 +29,7 @@
 #include "maidsafe/common/rsa.h"
 
 #include "maidsafe/routing/node_info.h"
+#include "maidsafe/routing/route_cache.h"
 #include "maidsafe/routing/types.h"
 
 namespace maidsafe {
@@ -80,7 +81,7 @@ class RoutingTable {
   // This returns a collection of contacts to which a message should be sent onwards.  It will
   // return all of our close group (comprising 'GroupSize' contacts) if the closest one to the
   // target is within our close group.  If not, it will return the 'Parallelism()' closest contacts
-  // to the target.
+  // to the target.  Results are cached by the target's leading bits until our membership changes.
   std::vector<NodeInfo> TargetNodes(const Address& target) const;
 
   // This returns our close group, i.e. the 'GroupSize' contacts closest to our ID (or the entire
@@ -94,6 +95,12 @@ class RoutingTable {
 
   size_t Size() const;
 
+  // Incremented each time a contact is added or dropped.
+  uint64_t Epoch() const;
+  // TargetNodes calls answered from, and not from, the cache of its earlier results.
+  uint64_t RouteCacheHits() const;
+  uint64_t RouteCacheMisses() const;
+
   int32_t BucketIndex(const Address& node_id) const;
 
  private:
@@ -115,12 +122,17 @@ class RoutingTable {
   bool NewNodeIsBetterThanExisting(const Address& their_id,
                                    std::vector<NodeInfo>::const_iterator removal_candidate) const;
   void PushBackThenSort(NodeInfo their_info);
+  void MembershipChanged();
   std::vector<NodeInfo>::const_iterator FindCandidateForRemoval() const;
 
   const Address our_id_;
   const Comparison comparison_;
   mutable std::mutex mutex_;
   std::vector<NodeInfo> nodes_;
+  uint64_t epoch_;
+  // TargetNodes' results depend only on the target's prefix while no two contacts share one
+  bool prefixes_distinct_;
+  mutable RouteCache<std::vector<NodeInfo>> route_cache_;
 };
 
 }  // namespace routing
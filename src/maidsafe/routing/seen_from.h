@@ -0,0 +1,103 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+
+#ifndef MAIDSAFE_ROUTING_SEEN_FROM_H_
+#define MAIDSAFE_ROUTING_SEEN_FROM_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Records the peers each recently seen message arrived from, duplicates included, so that it is not
+// forwarded to a peer already known to hold it.  The filter drops duplicates without a trace, so
+// they must be added here before that check.  Up to 'peers_per_message' peers are kept for each of
+// the last 'capacity' messages; once full, the oldest message is forgotten to make room for the
+// next.  Not thread-safe.
+class SeenFrom {
+ public:
+  explicit SeenFrom(size_t capacity = 1024, size_t peers_per_message = GroupSize)
+      : capacity_(capacity), peers_per_message_(peers_per_message), order_(), peers_() {}
+
+  SeenFrom(const SeenFrom&) = delete;
+  SeenFrom(SeenFrom&&) = delete;
+  ~SeenFrom() = default;
+  SeenFrom& operator=(const SeenFrom&) = delete;
+  SeenFrom& operator=(SeenFrom&&) = delete;
+
+  // 'key' is the message's FilterValue.
+  void Add(const FilterType& key, const Address& peer) {
+    if (capacity_ == 0)
+      return;
+    auto found(peers_.find(key));
+    if (found == std::end(peers_)) {
+      if (order_.size() == capacity_) {
+        peers_.erase(order_.front());
+        order_.pop_front();
+      }
+      order_.push_back(key);
+      found = peers_.emplace(key, std::vector<Address>()).first;
+    }
+    auto& peers(found->second);
+    if (peers.size() < peers_per_message_ &&
+        std::find(std::begin(peers), std::end(peers), peer) == std::end(peers))
+      peers.push_back(peer);
+  }
+
+  bool Contains(const FilterType& key, const Address& peer) const {
+    const auto found(peers_.find(key));
+    return found != std::end(peers_) &&
+           std::find(std::begin(found->second), std::end(found->second), peer) !=
+               std::end(found->second);
+  }
+
+  // Removes from 'targets' the message's originator and every peer it has arrived from, and
+  // returns the number removed.  The order of the remaining targets is kept.
+  size_t RemoveHolders(const FilterType& key, std::vector<Address>& targets) const {
+    const auto before(targets.size());
+    targets.erase(std::remove_if(std::begin(targets), std::end(targets),
+                                 [&](const Address& target) {
+                                   return target == key.first.data || Contains(key, target);
+                                 }),
+                  std::end(targets));
+    return before - targets.size();
+  }
+
+  size_t size() const { return peers_.size(); }
+
+ private:
+  const size_t capacity_;
+  const size_t peers_per_message_;
+  std::deque<FilterType> order_;
+  std::map<FilterType, std::vector<Address>> peers_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_SEEN_FROM_H_
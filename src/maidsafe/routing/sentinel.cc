@@ -27,6 +27,7 @@
 #include "maidsafe/routing/messages/get_client_key_response.h"
 #include "maidsafe/routing/messages/get_group_key_response.h"
 #include "maidsafe/routing/account_transfer_info.h"
+#include "maidsafe/routing/signature_scheme.h"
 
 namespace maidsafe {
 
@@ -35,6 +36,10 @@ namespace routing {
 boost::optional<Sentinel::ResultType> Sentinel::Add(MessageHeader header,
                                                     MessageTypeTag tag,
                                                     SerialisedMessage message) {
+  if (!Plausible(header)) {
+    ++implausible_dropped_;
+    return boost::none;
+  }
   if (tag == MessageTypeTag::GetClientKeyResponse) {
     if (!header.FromGroup())  // keys should always come from a group, one reponse should be enough
       BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
@@ -49,6 +54,7 @@ boost::optional<Sentinel::ResultType> Sentinel::Add(MessageHeader header,
                                   messages->second, keys->second), SingleMessage()));
         if (resolved) {
           node_accumulator_.Delete(key);
+          resolved_.Add(key);
           return resolved;
         }
       }
@@ -67,6 +73,7 @@ boost::optional<Sentinel::ResultType> Sentinel::Add(MessageHeader header,
                                   messages->second, keys->second), GroupMessage()));
         if (resolved) {
           group_accumulator_.Delete(key);
+          resolved_.Add(key);
           return resolved;
         }
       }
@@ -74,7 +81,11 @@ boost::optional<Sentinel::ResultType> Sentinel::Add(MessageHeader header,
   } else {
     if (header.FromGroup()) {
       auto key(std::make_pair(*header.FromGroup(), header.MessageId()));
-      if (!group_accumulator_.HaveName(key))
+      if (resolved_.Contains(key)) {
+        ++late_dropped_;
+        return boost::none;
+      }
+      if (!group_accumulator_.HaveName(key) && !HaveGroupKeys(*header.FromGroup()))
         send_get_group_key_(*header.FromGroup());
       auto messages(group_accumulator_.Add(key, std::make_tuple(header, tag, std::move(message)),
                                            header.FromNode()));
@@ -86,12 +97,24 @@ boost::optional<Sentinel::ResultType> Sentinel::Add(MessageHeader header,
                                 GroupMessage()));
           if (resolved) {
             group_accumulator_.Delete(key);
+            resolved_.Add(key);
             return resolved;
           }
+          // A quorum of the group signed, but not with the keys we hold: its membership may have
+          // changed since we fetched them, so fetch them afresh, once per message.
+          if (!keys_refetched_.Contains(key)) {
+            keys_refetched_.Add(key);
+            ++keys_refetched_count_;
+            send_get_group_key_(*header.FromGroup());
+          }
         }
       }
     } else {
       auto key(std::make_pair(header.FromNode(), header.MessageId()));
+      if (resolved_.Contains(key)) {
+        ++late_dropped_;
+        return boost::none;
+      }
       if (!node_accumulator_.HaveName(key))
         send_get_client_key_(header.FromNode());
       auto messages(node_accumulator_.Add(key, std::make_tuple(header, tag, std::move(message)),
@@ -104,6 +127,7 @@ boost::optional<Sentinel::ResultType> Sentinel::Add(MessageHeader header,
                                 SingleMessage()));
           if (resolved) {
             node_accumulator_.Delete(key);
+            resolved_.Add(key);
             return resolved;
           }
         }
@@ -144,15 +168,31 @@ Sentinel::Validate<Sentinel::NodeAccumulatorType, Sentinel::KeyAccumulatorType>(
   assert(keys_map.size() == 1);
   assert(keys_map.begin()->second.size() == 1);
 
-  auto& public_key(*keys_map.begin()->second.begin());
-  if (!asymm::ValidateKey(public_key))
+  const auto verifier(MakeRsaVerifier(*keys_map.begin()->second.begin()));
+  if (!verifier)
     return std::vector<ResultType>();
 
+  // All the messages are from the one key, so are checked as a batch.
+  std::vector<const ResultType*> signed_messages;
+  std::vector<asymm::Signature> signatures;
+  signed_messages.reserve(messages.size());
+  signatures.reserve(messages.size());
   for (const auto& message : messages) {
-    auto signature(std::get<0>(message.second).Signature());
-    if (signature && asymm::CheckSignature(
-          rsa::PlainText(std::get<2>(message.second)), *signature, public_key))
-      verified_messages.emplace_back(message.second);
+    const auto& header(std::get<0>(message.second));
+    auto signature(header.Signature());
+    if (signature && header.SignedWith() == verifier->Scheme()) {
+      signed_messages.push_back(&message.second);
+      signatures.push_back(std::move(*signature));
+    }
+  }
+  std::vector<Verifier::SignedMessage> batch;
+  batch.reserve(signed_messages.size());
+  for (size_t i(0); i < signed_messages.size(); ++i)
+    batch.emplace_back(&std::get<2>(*signed_messages[i]), &signatures[i]);
+  const auto valid(verifier->VerifyBatch(batch));
+  for (size_t i(0); i < signed_messages.size(); ++i) {
+    if (valid[i])
+      verified_messages.emplace_back(*signed_messages[i]);
   }
 
   if (verified_messages.size() >= 1)
@@ -174,7 +214,7 @@ Sentinel::Validate<Sentinel::GroupAccumulatorType, Sentinel::KeyAccumulatorType>
 
   for (const auto& group_keys : keys) {
     auto group_key_response(Parse<GetGroupKeyResponse>(std::get<2>(group_keys.second)));
-    auto public_keys(group_key_response.public_keys());
+    const auto& public_keys(group_key_response.public_keys());
     for (const auto& public_key : public_keys) {
       if (keys_map.find(public_key.first) == keys_map.end()) {
         keys_map.insert(std::make_pair(public_key.first,
@@ -201,13 +241,14 @@ Sentinel::Validate<Sentinel::GroupAccumulatorType, Sentinel::KeyAccumulatorType>
     if (keys_map_iter == keys_map.end())
       continue;
 
-    auto public_key(*keys_map_iter->second.begin());
-    if (!asymm::ValidateKey(public_key))
+    const auto verifier(MakeRsaVerifier(*keys_map_iter->second.begin()));
+    if (!verifier)
       continue;
 
-    auto signature(std::get<0>(message.second).Signature());
-    if (signature && asymm::CheckSignature(
-          rsa::PlainText(std::get<2>(message.second)), *signature, public_key))
+    const auto& header(std::get<0>(message.second));
+    auto signature(header.Signature());
+    if (signature && header.SignedWith() == verifier->Scheme() &&
+        verifier->Verify(std::get<2>(message.second), *signature))
       verified_messages.emplace_back(message.second);
   }
 
@@ -20,6 +20,7 @@
 #define MAIDSAFE_ROUTING_SENTINEL_H_
 
 #include <chrono>
+#include <cstdint>
 #include <future>
 #include <vector>
 #include <utility>
@@ -31,6 +32,7 @@
 
 #include "maidsafe/routing/accumulator.h"
 #include "maidsafe/routing/message_header.h"
+#include "maidsafe/routing/tombstones.h"
 #include "maidsafe/routing/types.h"
 #include "maidsafe/routing/messages/messages_fwd.h"
 
@@ -42,8 +44,20 @@ class Sentinel {
  public:
   // TODO(mmoadeli): ResultType below may have extra information which could be removed later
   using ResultType = std::tuple<MessageHeader, MessageTypeTag, SerialisedMessage>;
-  Sentinel(SendGetClientKey send_get_client_key, SendGetGroupKey send_get_group_key)
-      : send_get_client_key_(send_get_client_key), send_get_group_key_(send_get_group_key) {}
+  Sentinel(SendGetClientKey send_get_client_key, SendGetGroupKey send_get_group_key,
+           std::chrono::steady_clock::duration time_to_live = std::chrono::minutes(20))
+      : send_get_client_key_(send_get_client_key),
+        send_get_group_key_(send_get_group_key),
+        node_accumulator_(time_to_live, 1U),
+        group_accumulator_(time_to_live, QuorumSize),
+        group_key_accumulator_(time_to_live, QuorumSize),
+        node_key_accumulator_(time_to_live, QuorumSize),
+        close_group_leading_bits_(0),
+        implausible_dropped_(0),
+        resolved_(),
+        late_dropped_(0),
+        keys_refetched_(),
+        keys_refetched_count_(0) {}
   Sentinel(const Sentinel&) = delete;
   Sentinel(Sentinel&&) = delete;
   ~Sentinel() = default;
@@ -52,6 +66,27 @@ class Sentinel {
   // at some stage this will return a valid answer when all data is accumulated
   // and signatures checked
   boost::optional<ResultType> Add(MessageHeader, MessageTypeTag, SerialisedMessage);
+  // True if a quorum of 'group's keys is already held, so messages from it need no key fetch
+  // unless those keys then fail to validate them.
+  bool HaveGroupKeys(const GroupAddress& group) const {
+    return group_key_accumulator_.CheckQuorumReached(group);
+  }
+  // The leading bits we share with the furthest member of our full close group, or 0 if our close
+  // group isn't full.  Group members share about as many with their group's address, so a message
+  // whose sender shares far fewer with the group it claims is dropped by Add before it is
+  // accumulated or has keys fetched for it.
+  void SetCloseGroupLeadingBits(int leading_bits) { close_group_leading_bits_ = leading_bits; }
+  uint64_t ImplausibleDropped() const { return implausible_dropped_; }
+  // Copies of an already resolved message which arrived after its quorum and were dropped rather
+  // than accumulated afresh.
+  uint64_t LateDropped() const { return late_dropped_; }
+  // Group messages whose quorum failed against the keys held, so that the keys were fetched again.
+  uint64_t KeysRefetched() const { return keys_refetched_count_; }
+  // Message parts held while waiting for a quorum or for keys.
+  size_t AccumulatedParts() const {
+    return node_accumulator_.parts() + group_accumulator_.parts() +
+           group_key_accumulator_.parts() + node_key_accumulator_.parts();
+  }
 
  private:
   using NodeKeyType = std::pair<NodeAddress, routing::MessageId>;
@@ -69,15 +104,30 @@ class Sentinel {
   boost::optional<ResultType>
   Resolve(const std::vector<ResultType>& verified_messages, GroupMessage);
 
+  // False if 'header' claims a group its sender is too far from to belong to.  Group densities
+  // vary, so 'kLeadingBitsSlack' fewer bits than our own close group's are tolerated.
+  bool Plausible(const MessageHeader& header) const {
+    const auto leading_bits(header.FromGroupCommonLeadingBits());
+    return leading_bits < 0 || leading_bits >= close_group_leading_bits_ - kLeadingBitsSlack;
+  }
+  static const int kLeadingBitsSlack = 4;
+
   boost::optional<ResultType>
   Resolve(const std::vector<ResultType>& verified_messages, SingleMessage);
 
   SendGetClientKey send_get_client_key_;
   SendGetGroupKey send_get_group_key_;
-  NodeAccumulatorType node_accumulator_{std::chrono::minutes(20), 1U};
-  GroupAccumulatorType group_accumulator_{std::chrono::minutes(20), QuorumSize};
-  KeyAccumulatorType group_key_accumulator_{std::chrono::minutes(20), QuorumSize};
-  KeyAccumulatorType node_key_accumulator_{std::chrono::minutes(20), QuorumSize};
+  NodeAccumulatorType node_accumulator_;
+  GroupAccumulatorType group_accumulator_;
+  KeyAccumulatorType group_key_accumulator_;
+  KeyAccumulatorType node_key_accumulator_;
+  int close_group_leading_bits_;
+  uint64_t implausible_dropped_;
+  Tombstones resolved_;
+  uint64_t late_dropped_;
+  // group messages we have already refetched keys for
+  Tombstones keys_refetched_;
+  uint64_t keys_refetched_count_;
 };
 
 template <>
@@ -0,0 +1,597 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/shared_memory_ring.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef MAIDSAFE_LINUX
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace {
+
+const uint64_t kRingMagic = 0x6d7364726e677231;  // "msdrngr1"
+const char kHostIdMarker[] = {'H', 'O', 'S', 'T'};
+const std::size_t kCacheLine = 64;
+// how long the reader waits for the peer to create its ring, and how often it looks
+const std::chrono::seconds kOpenTimeout(5);
+const std::chrono::milliseconds kOpenRetry(20);
+// the longest the reader sleeps with nothing to open, though it is woken for anything it must do
+const std::chrono::milliseconds kIdleTimeout(1000);
+// how often a producer checks that its consumer's process is still running
+const std::chrono::seconds kLivenessInterval(1);
+
+std::size_t RoundUpToPowerOfTwo(std::size_t value) {
+  std::size_t result(1);
+  while (result < value)
+    result <<= 1;
+  return result;
+}
+
+std::string Hex(const std::string& bytes) {
+  static const char kDigits[] = "0123456789abcdef";
+  std::string result;
+  result.reserve(bytes.size() * 2);
+  for (const auto c : bytes) {
+    result.push_back(kDigits[(static_cast<unsigned char>(c) >> 4) & 0xF]);
+    result.push_back(kDigits[static_cast<unsigned char>(c) & 0xF]);
+  }
+  return result;
+}
+
+}  // unnamed namespace
+
+// Lives at the start of the segment.  The producer and consumer positions are on separate cache
+// lines so that neither side's writes evict the other's.
+struct SharedMemoryRing::Control {
+  std::atomic<uint64_t> magic;
+  uint64_t capacity;
+  // the process which Created the ring, and the one which has it open, if any, else 0
+  std::atomic<int32_t> producer_pid;
+  std::atomic<int32_t> consumer_pid;
+  alignas(kCacheLine) std::atomic<uint64_t> head;  // bytes ever pushed; written by the producer
+  alignas(kCacheLine) std::atomic<uint64_t> tail;  // bytes ever popped; written by the consumer
+  alignas(kCacheLine) std::atomic<uint32_t> consumer_waiting;
+};
+
+std::string SharedMemoryRingName(const Address& from, const Address& to) {
+  return "/maidsafe_routing_" + Hex(from.string().substr(0, 8)) + "_" +
+         Hex(to.string().substr(0, 8));
+}
+
+void AppendHostId(const std::string& host_id, SerialisedMessage& handshake) {
+  if (host_id.empty() || host_id.size() > 255)
+    return;
+  handshake.insert(std::end(handshake), std::begin(host_id), std::end(host_id));
+  handshake.push_back(static_cast<byte>(host_id.size()));
+  handshake.insert(std::end(handshake), std::begin(kHostIdMarker), std::end(kHostIdMarker));
+}
+
+std::string TakeHostId(SerialisedMessage& handshake) {
+  const auto marker_size(sizeof(kHostIdMarker));
+  if (handshake.size() < marker_size + 1 ||
+      !std::equal(std::end(handshake) - marker_size, std::end(handshake), kHostIdMarker))
+    return std::string();
+  const std::size_t size(handshake[handshake.size() - marker_size - 1]);
+  if (handshake.size() < marker_size + 1 + size)
+    return std::string();
+  const auto begin(std::end(handshake) - marker_size - 1 - size);
+  std::string host_id(begin, begin + size);
+  handshake.erase(begin, std::end(handshake));
+  return host_id;
+}
+
+#ifdef MAIDSAFE_LINUX
+
+namespace {
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && ATOMIC_INT_LOCK_FREE == 2,
+              "futex word must be a plain lock-free 32-bit integer");
+
+long Futex(std::atomic<uint32_t>* word, int operation, uint32_t value,  // NOLINT
+           const timespec* timeout) {
+  return syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), operation, value, timeout, nullptr,
+                 0);
+}
+
+}  // unnamed namespace
+
+std::string LocalHostId() {
+  std::ifstream boot_id("/proc/sys/kernel/random/boot_id");
+  std::string id;
+  std::getline(boot_id, id);
+  return id;
+}
+
+namespace {
+
+std::string DoorbellName(int pid) { return "/maidsafe_routing_doorbell_" + std::to_string(pid); }
+
+bool ProcessAlive(int pid) { return kill(pid, 0) == 0 || errno == EPERM; }
+
+void* MapDoorbell(int fd) {
+  void* mapping(MAP_FAILED);
+  if (fd != -1) {
+    if (ftruncate(fd, static_cast<off_t>(kCacheLine)) == 0)
+      mapping = mmap(nullptr, kCacheLine, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+  }
+  if (mapping == MAP_FAILED)
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  return mapping;
+}
+
+}  // unnamed namespace
+
+SharedMemoryDoorbell& SharedMemoryDoorbell::Ours() {
+  static const std::unique_ptr<SharedMemoryDoorbell> ours([] {
+    const auto name(DoorbellName(getpid()));
+    // any doorbell already under our pid was left by a process which has since died
+    shm_unlink(name.c_str());
+    const int fd(shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR));
+    auto mapping(MapDoorbell(fd));
+    new (mapping) std::atomic<uint32_t>(0);
+    return std::unique_ptr<SharedMemoryDoorbell>(new SharedMemoryDoorbell(name, true, mapping));
+  }());
+  return *ours;
+}
+
+std::unique_ptr<SharedMemoryDoorbell> SharedMemoryDoorbell::Open(int pid) {
+  const auto name(DoorbellName(pid));
+  return std::unique_ptr<SharedMemoryDoorbell>(
+      new SharedMemoryDoorbell(name, false, MapDoorbell(shm_open(name.c_str(), O_RDWR, 0))));
+}
+
+SharedMemoryDoorbell::SharedMemoryDoorbell(std::string name, bool owner, void* mapping)
+    : name_(std::move(name)),
+      owner_(owner),
+      sequence_(static_cast<std::atomic<uint32_t>*>(mapping)) {}
+
+SharedMemoryDoorbell::~SharedMemoryDoorbell() {
+  munmap(sequence_, kCacheLine);
+  if (owner_)
+    shm_unlink(name_.c_str());
+}
+
+uint32_t SharedMemoryDoorbell::Sequence() const {
+  return sequence_->load(std::memory_order_acquire);
+}
+
+void SharedMemoryDoorbell::Wait(uint32_t sequence, std::chrono::milliseconds timeout) {
+  timespec relative{static_cast<time_t>(timeout.count() / 1000),
+                    static_cast<long>((timeout.count() % 1000) * 1000000)};  // NOLINT
+  // returns straight away if rung since 'sequence' was read
+  Futex(sequence_, FUTEX_WAIT, sequence, &relative);
+}
+
+void SharedMemoryDoorbell::Ring() {
+  sequence_->fetch_add(1, std::memory_order_release);
+  Futex(sequence_, FUTEX_WAKE, INT_MAX, nullptr);
+}
+
+std::unique_ptr<SharedMemoryRing> SharedMemoryRing::Create(const std::string& name,
+                                                           std::size_t capacity) {
+  capacity = RoundUpToPowerOfTwo(std::max(capacity, kCacheLine));
+  int fd(shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR));
+  // A ring still in use, e.g. by a channel to the same peer not yet closed, is left alone.
+  if (fd == -1 && errno == EEXIST && Abandoned(name)) {
+    shm_unlink(name.c_str());
+    fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+  }
+  if (fd == -1)
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  const auto mapping_size(MappingSize(capacity));
+  void* mapping(MAP_FAILED);
+  if (ftruncate(fd, static_cast<off_t>(mapping_size)) == 0)
+    mapping = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    shm_unlink(name.c_str());
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  }
+  auto control(new (mapping) Control);
+  control->capacity = capacity;
+  control->producer_pid = getpid();
+  control->consumer_pid = 0;
+  control->head = 0;
+  control->tail = 0;
+  control->consumer_waiting = 0;
+  // published last, so an opener never sees a half-initialised ring
+  control->magic.store(kRingMagic, std::memory_order_release);
+  return std::unique_ptr<SharedMemoryRing>(
+      new SharedMemoryRing(name, true, mapping, mapping_size));
+}
+
+std::unique_ptr<SharedMemoryRing> SharedMemoryRing::Open(const std::string& name) {
+  const int fd(shm_open(name.c_str(), O_RDWR, 0));
+  if (fd == -1)
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  struct stat status;
+  void* mapping(MAP_FAILED);
+  std::size_t mapping_size(0);
+  if (fstat(fd, &status) == 0 && static_cast<std::size_t>(status.st_size) > sizeof(Control)) {
+    mapping_size = static_cast<std::size_t>(status.st_size);
+    mapping = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if (mapping == MAP_FAILED)
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  const auto control(static_cast<Control*>(mapping));
+  if (control->magic.load(std::memory_order_acquire) != kRingMagic ||
+      MappingSize(static_cast<std::size_t>(control->capacity)) != mapping_size) {
+    munmap(mapping, mapping_size);
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+  }
+  control->consumer_pid.store(getpid(), std::memory_order_release);
+  return std::unique_ptr<SharedMemoryRing>(
+      new SharedMemoryRing(name, false, mapping, mapping_size));
+}
+
+SharedMemoryRing::SharedMemoryRing(std::string name, bool owner, void* mapping,
+                                   std::size_t mapping_size)
+    : name_(std::move(name)),
+      owner_(owner),
+      mapping_(mapping),
+      mapping_size_(mapping_size),
+      control_(static_cast<Control*>(mapping)),
+      data_(static_cast<byte*>(mapping) + RoundUpToPowerOfTwo(sizeof(Control))),
+      capacity_(static_cast<std::size_t>(control_->capacity)),
+      consumer_doorbell_(),
+      consumer_doorbell_pid_(0),
+      checked_pid_(0),
+      consumer_alive_(false),
+      next_liveness_check_() {}
+
+std::size_t SharedMemoryRing::MappingSize(std::size_t capacity) {
+  return RoundUpToPowerOfTwo(sizeof(Control)) + capacity;
+}
+
+bool SharedMemoryRing::Abandoned(const std::string& name) {
+  const int fd(shm_open(name.c_str(), O_RDONLY, 0));
+  if (fd == -1)
+    return false;
+  struct stat status;
+  void* mapping(MAP_FAILED);
+  if (fstat(fd, &status) == 0 && static_cast<std::size_t>(status.st_size) >= sizeof(Control))
+    mapping = mmap(nullptr, sizeof(Control), PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED)
+    return false;
+  // one not yet holding a ring may still be being created
+  const auto control(static_cast<const Control*>(mapping));
+  const bool abandoned(control->magic.load(std::memory_order_acquire) == kRingMagic &&
+                       !ProcessAlive(control->producer_pid.load(std::memory_order_relaxed)));
+  munmap(mapping, sizeof(Control));
+  return abandoned;
+}
+
+SharedMemoryRing::~SharedMemoryRing() {
+  if (!owner_)
+    control_->consumer_pid.store(0, std::memory_order_release);
+  munmap(mapping_, mapping_size_);
+  if (owner_)
+    shm_unlink(name_.c_str());
+}
+
+bool SharedMemoryRing::TryPush(const SerialisedMessage& message) {
+  const uint32_t size(static_cast<uint32_t>(message.size()));
+  if (message.size() > capacity_ / 2)
+    return false;
+  const auto head(control_->head.load(std::memory_order_relaxed));
+  const auto tail(control_->tail.load(std::memory_order_acquire));
+  if (capacity_ - (head - tail) < sizeof(size) + size)
+    return false;
+  Copy(head, reinterpret_cast<const byte*>(&size), sizeof(size));
+  Copy(head + sizeof(size), message.data(), size);
+  // Sequentially consistent with the consumer's flag, so that either it sees the message before
+  // sleeping or we see that it is asleep.
+  control_->head.store(head + sizeof(size) + size, std::memory_order_seq_cst);
+  if (control_->consumer_waiting.load(std::memory_order_seq_cst))
+    WakeConsumer();
+  return true;
+}
+
+bool SharedMemoryRing::TryPop(SerialisedMessage& message) {
+  const auto tail(control_->tail.load(std::memory_order_relaxed));
+  const auto head(control_->head.load(std::memory_order_acquire));
+  if (head == tail)
+    return false;
+  uint32_t size(0);
+  CopyOut(tail, reinterpret_cast<byte*>(&size), sizeof(size));
+  if (size > capacity_ / 2 || head - tail < sizeof(size) + size) {
+    // only a misbehaving producer gets here; drop everything it has written
+    LOG(kError) << "Corrupt shared memory ring " << name_;
+    control_->tail.store(head, std::memory_order_release);
+    return false;
+  }
+  message.resize(size);
+  CopyOut(tail + sizeof(size), message.data(), size);
+  control_->tail.store(tail + sizeof(size) + size, std::memory_order_release);
+  return true;
+}
+
+bool SharedMemoryRing::StartWaiting() {
+  control_->consumer_waiting.store(1, std::memory_order_seq_cst);
+  return control_->head.load(std::memory_order_seq_cst) ==
+         control_->tail.load(std::memory_order_relaxed);
+}
+
+void SharedMemoryRing::StopWaiting() {
+  control_->consumer_waiting.store(0, std::memory_order_relaxed);
+}
+
+bool SharedMemoryRing::ConsumerAttached() const {
+  const auto pid(control_->consumer_pid.load(std::memory_order_acquire));
+  if (pid == 0)
+    return false;
+  // A consumer which crashed never clears its pid, so now and then we check it is still running.
+  const auto now(std::chrono::steady_clock::now());
+  if (pid != checked_pid_ || now >= next_liveness_check_) {
+    checked_pid_ = pid;
+    consumer_alive_ = ProcessAlive(pid);
+    next_liveness_check_ = now + kLivenessInterval;
+  }
+  return consumer_alive_;
+}
+
+void SharedMemoryRing::WakeConsumer() {
+  const auto pid(control_->consumer_pid.load(std::memory_order_acquire));
+  if (pid == 0)
+    return;
+  if (!consumer_doorbell_ || consumer_doorbell_pid_ != pid) {
+    try {
+      consumer_doorbell_ = SharedMemoryDoorbell::Open(pid);
+      consumer_doorbell_pid_ = pid;
+    } catch (const std::exception&) {
+      return;
+    }
+  }
+  consumer_doorbell_->Ring();
+}
+
+void SharedMemoryRing::Copy(uint64_t position, const byte* from, std::size_t size) {
+  const auto offset(static_cast<std::size_t>(position & (capacity_ - 1)));
+  const auto first(std::min(size, capacity_ - offset));
+  std::memcpy(data_ + offset, from, first);
+  std::memcpy(data_, from + first, size - first);
+}
+
+void SharedMemoryRing::CopyOut(uint64_t position, byte* to, std::size_t size) const {
+  const auto offset(static_cast<std::size_t>(position & (capacity_ - 1)));
+  const auto first(std::min(size, capacity_ - offset));
+  std::memcpy(to, data_ + offset, first);
+  std::memcpy(to + first, data_, size - first);
+}
+
+#else
+
+std::string LocalHostId() { return std::string(); }
+
+SharedMemoryDoorbell& SharedMemoryDoorbell::Ours() {
+  BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+}
+
+std::unique_ptr<SharedMemoryDoorbell> SharedMemoryDoorbell::Open(int) {
+  BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+}
+
+SharedMemoryDoorbell::~SharedMemoryDoorbell() {}
+
+uint32_t SharedMemoryDoorbell::Sequence() const { return 0; }
+
+void SharedMemoryDoorbell::Wait(uint32_t, std::chrono::milliseconds) {}
+
+void SharedMemoryDoorbell::Ring() {}
+
+std::unique_ptr<SharedMemoryRing> SharedMemoryRing::Create(const std::string&, std::size_t) {
+  BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+}
+
+std::unique_ptr<SharedMemoryRing> SharedMemoryRing::Open(const std::string&) {
+  BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+}
+
+SharedMemoryRing::~SharedMemoryRing() {}
+
+bool SharedMemoryRing::TryPush(const SerialisedMessage&) { return false; }
+
+bool SharedMemoryRing::TryPop(SerialisedMessage&) { return false; }
+
+bool SharedMemoryRing::StartWaiting() { return false; }
+
+void SharedMemoryRing::StopWaiting() {}
+
+bool SharedMemoryRing::ConsumerAttached() const { return false; }
+
+#endif
+
+// Reads the inbound ring of every SharedMemoryChannel in the process on a single thread.  While
+// all the rings are empty it sleeps on our SharedMemoryDoorbell, which their producers ring on
+// pushing a message; adding or removing a channel rings it too.
+class SharedMemoryPoller {
+ public:
+  // The poller in use, or a new one if there is none; it stops once no channel holds it.
+  static std::shared_ptr<SharedMemoryPoller> Get();
+
+  SharedMemoryPoller();
+  SharedMemoryPoller(const SharedMemoryPoller&) = delete;
+  SharedMemoryPoller(SharedMemoryPoller&&) = delete;
+  ~SharedMemoryPoller();
+  SharedMemoryPoller& operator=(const SharedMemoryPoller&) = delete;
+  SharedMemoryPoller& operator=(SharedMemoryPoller&&) = delete;
+
+  // Reads 'ring_name' for 'channel' once its producer has created it, posting each message popped
+  // to 'on_receive' on 'io_service'.
+  void Add(const SharedMemoryChannel* channel, std::string ring_name,
+           boost::asio::io_service& io_service, std::function<void(SerialisedMessage)> on_receive);
+  // On return the ring is closed and nothing more is posted for 'channel'.
+  void Remove(const SharedMemoryChannel* channel);
+
+ private:
+  struct Reader {
+    const SharedMemoryChannel* channel;
+    std::string ring_name;
+    std::chrono::steady_clock::time_point give_up;
+    boost::asio::io_service* io_service;
+    std::function<void(SerialisedMessage)> on_receive;
+    std::unique_ptr<SharedMemoryRing> ring;
+  };
+
+  void Run();
+
+  SharedMemoryDoorbell& doorbell_;
+  std::mutex mutex_;
+  std::vector<Reader> readers_;
+  std::atomic<bool> stopped_;
+  std::thread thread_;
+};
+
+std::shared_ptr<SharedMemoryPoller> SharedMemoryPoller::Get() {
+  static std::mutex mutex;
+  static std::weak_ptr<SharedMemoryPoller> current;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto poller(current.lock());
+  if (!poller) {
+    poller = std::make_shared<SharedMemoryPoller>();
+    current = poller;
+  }
+  return poller;
+}
+
+SharedMemoryPoller::SharedMemoryPoller()
+    : doorbell_(SharedMemoryDoorbell::Ours()),
+      mutex_(),
+      readers_(),
+      stopped_(false),
+      thread_([this] { Run(); }) {}
+
+SharedMemoryPoller::~SharedMemoryPoller() {
+  stopped_ = true;
+  doorbell_.Ring();
+  thread_.join();
+}
+
+void SharedMemoryPoller::Add(const SharedMemoryChannel* channel, std::string ring_name,
+                             boost::asio::io_service& io_service,
+                             std::function<void(SerialisedMessage)> on_receive) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    readers_.push_back(Reader{channel, std::move(ring_name),
+                              std::chrono::steady_clock::now() + kOpenTimeout, &io_service,
+                              std::move(on_receive), nullptr});
+  }
+  doorbell_.Ring();
+}
+
+void SharedMemoryPoller::Remove(const SharedMemoryChannel* channel) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  readers_.erase(std::remove_if(std::begin(readers_), std::end(readers_),
+                                [channel](const Reader& reader) {
+                                  return reader.channel == channel;
+                                }),
+                 std::end(readers_));
+}
+
+void SharedMemoryPoller::Run() {
+  SerialisedMessage message;
+  while (!stopped_) {
+    // read first, so that a ring pushed to or a channel added from here on cuts the sleep short
+    const auto sequence(doorbell_.Sequence());
+    bool popped(false), opening(false);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      const auto now(std::chrono::steady_clock::now());
+      for (auto& reader : readers_) {
+        if (!reader.ring) {
+          if (now > reader.give_up)
+            continue;
+          try {
+            reader.ring = SharedMemoryRing::Open(reader.ring_name);
+          } catch (const std::exception&) {
+            opening = true;
+            continue;
+          }
+        }
+        while (reader.ring->TryPop(message)) {
+          auto on_receive(reader.on_receive);
+          auto received(std::make_shared<SerialisedMessage>(std::move(message)));
+          reader.io_service->post([on_receive, received] { on_receive(std::move(*received)); });
+          popped = true;
+        }
+      }
+    }
+    if (popped)
+      continue;
+    bool all_empty(true);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (auto& reader : readers_) {
+        if (reader.ring && !reader.ring->StartWaiting())
+          all_empty = false;
+      }
+    }
+    if (all_empty)
+      doorbell_.Wait(sequence, opening ? kOpenRetry : kIdleTimeout);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (auto& reader : readers_) {
+        if (reader.ring)
+          reader.ring->StopWaiting();
+      }
+    }
+  }
+}
+
+SharedMemoryChannel::SharedMemoryChannel(boost::asio::io_service& io_service,
+                                         const Address& our_id, const Address& their_id,
+                                         std::size_t capacity,
+                                         std::function<void(SerialisedMessage)> on_receive)
+    : io_service_(io_service),
+      outbound_(SharedMemoryRing::Create(SharedMemoryRingName(our_id, their_id), capacity)),
+      poller_(SharedMemoryPoller::Get()) {
+  poller_->Add(this, SharedMemoryRingName(their_id, our_id), io_service_, std::move(on_receive));
+}
+
+SharedMemoryChannel::~SharedMemoryChannel() { poller_->Remove(this); }
+
+}  // namespace routing
+
+}  // namespace maidsafe
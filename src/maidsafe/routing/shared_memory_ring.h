@@ -0,0 +1,187 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_SHARED_MEMORY_RING_H_
+#define MAIDSAFE_ROUTING_SHARED_MEMORY_RING_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "boost/asio/io_service.hpp"
+
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Identifies the running kernel, so that two nodes which exchange it during their handshake can
+// tell they share a host and may talk through shared memory.  Empty where shared memory transport
+// is unsupported (anywhere but Linux) or the id can't be read.
+std::string LocalHostId();
+
+// Name of the ring carrying messages from 'from' to 'to'; each end creates the ring it writes to.
+std::string SharedMemoryRingName(const Address& from, const Address& to);
+
+// Our host id travels after the PublicPmid in the connect handshake, followed by its length and a
+// marker.  Nodes predating it parse the PublicPmid and ignore the trailing bytes.
+void AppendHostId(const std::string& host_id, SerialisedMessage& handshake);
+// Removes the host id from the end of 'handshake', returning it, or empty if there is none.
+std::string TakeHostId(SerialisedMessage& handshake);
+
+// A futex in a small shared memory segment named after the process owning it, on which that
+// process's reader sleeps while every ring it reads is empty.  The producer of a ring Rings its
+// consumer's doorbell after pushing a message if the consumer has said it is waiting.  Throws
+// CommonErrors::filesystem_io_error if the segment can't be created, opened or mapped.
+class SharedMemoryDoorbell {
+ public:
+  // This process's doorbell, created on first use and removed at exit.
+  static SharedMemoryDoorbell& Ours();
+  // The doorbell of process 'pid'.
+  static std::unique_ptr<SharedMemoryDoorbell> Open(int pid);
+
+  SharedMemoryDoorbell(const SharedMemoryDoorbell&) = delete;
+  SharedMemoryDoorbell(SharedMemoryDoorbell&&) = delete;
+  ~SharedMemoryDoorbell();
+  SharedMemoryDoorbell& operator=(const SharedMemoryDoorbell&) = delete;
+  SharedMemoryDoorbell& operator=(SharedMemoryDoorbell&&) = delete;
+
+  // Read before checking whether there is anything to wait for, and passed to Wait.
+  uint32_t Sequence() const;
+  // Blocks until Ring is called after 'sequence' was read, or 'timeout' passes.
+  void Wait(uint32_t sequence, std::chrono::milliseconds timeout);
+  // Wakes every thread blocked in Wait.
+  void Ring();
+
+ private:
+  SharedMemoryDoorbell(std::string name, bool owner, void* mapping);
+
+  const std::string name_;
+  const bool owner_;
+  std::atomic<uint32_t>* const sequence_;
+};
+
+// A single-producer single-consumer queue of messages in a named POSIX shared memory segment.
+// Messages are copied in once by the producer and out once by the consumer, with no system call
+// on either side unless the consumer has gone to sleep waiting for data; it is then woken via its
+// process's SharedMemoryDoorbell.  One end Creates the ring (and unlinks its name on destruction)
+// and the other Opens it, recording its process id in the ring until it closes it again.  Only one
+// thread may push and one pop.  Throws CommonErrors::filesystem_io_error if the segment can't be
+// created or mapped, or the name is taken by a ring whose creator is still running, and
+// CommonErrors::invalid_argument if an opened segment is not a ring.
+class SharedMemoryRing {
+ public:
+  // 'capacity' is rounded up to a power of two.  A segment of the same name left by a process which
+  // has since died is replaced.
+  static std::unique_ptr<SharedMemoryRing> Create(const std::string& name, std::size_t capacity);
+  static std::unique_ptr<SharedMemoryRing> Open(const std::string& name);
+
+  SharedMemoryRing(const SharedMemoryRing&) = delete;
+  SharedMemoryRing(SharedMemoryRing&&) = delete;
+  ~SharedMemoryRing();
+  SharedMemoryRing& operator=(const SharedMemoryRing&) = delete;
+  SharedMemoryRing& operator=(SharedMemoryRing&&) = delete;
+
+  // Returns false if there isn't room for 'message'.  Messages larger than half the capacity are
+  // never accepted.
+  bool TryPush(const SerialisedMessage& message);
+  // Returns false if the ring is empty.
+  bool TryPop(SerialisedMessage& message);
+  // Called by the consumer before sleeping on its doorbell, so that the next push rings it.
+  // Returns false if there is already a message to pop, in which case it mustn't sleep.
+  bool StartWaiting();
+  void StopWaiting();
+  // True once the other end has opened the ring, and until it closes it or its process dies.  A
+  // producer pushing before then may have its messages left unread, e.g. where the peer can't map
+  // our segment.
+  bool ConsumerAttached() const;
+
+  std::size_t capacity() const { return capacity_; }
+
+ private:
+  struct Control;
+
+  SharedMemoryRing(std::string name, bool owner, void* mapping, std::size_t mapping_size);
+  static std::size_t MappingSize(std::size_t capacity);
+  // true if 'name' holds a ring whose creator is no longer running
+  static bool Abandoned(const std::string& name);
+  void WakeConsumer();
+  void Copy(uint64_t position, const byte* from, std::size_t size);
+  void CopyOut(uint64_t position, byte* to, std::size_t size) const;
+
+  const std::string name_;
+  const bool owner_;
+  void* const mapping_;
+  const std::size_t mapping_size_;
+  Control* const control_;
+  byte* const data_;
+  const std::size_t capacity_;
+  // producer only: the consumer's doorbell, and when its process was last seen running
+  std::unique_ptr<SharedMemoryDoorbell> consumer_doorbell_;
+  int consumer_doorbell_pid_;
+  mutable int checked_pid_;
+  mutable bool consumer_alive_;
+  mutable std::chrono::steady_clock::time_point next_liveness_check_;
+};
+
+class SharedMemoryPoller;
+
+// Carries messages between two nodes on the same host through a pair of SharedMemoryRings, in
+// place of their UDP connection.  Our ring is created straight away.  The peer's ring is read by
+// one thread shared by every channel in the process, which opens it as soon as the peer has
+// created it and hands each message it pops to 'on_receive' on 'io_service'.  If the peer's ring
+// doesn't appear within a few seconds it gives up and only the UDP connection is used to receive.
+// Likewise nothing is sent through our ring until the peer has opened it, as it may never manage
+// to: a matching host id doesn't guarantee a shared /dev/shm, e.g. between containers.
+class SharedMemoryChannel {
+ public:
+  SharedMemoryChannel(boost::asio::io_service& io_service, const Address& our_id,
+                      const Address& their_id, std::size_t capacity,
+                      std::function<void(SerialisedMessage)> on_receive);
+  SharedMemoryChannel(const SharedMemoryChannel&) = delete;
+  SharedMemoryChannel(SharedMemoryChannel&&) = delete;
+  ~SharedMemoryChannel();
+  SharedMemoryChannel& operator=(const SharedMemoryChannel&) = delete;
+  SharedMemoryChannel& operator=(SharedMemoryChannel&&) = delete;
+
+  // Returns false if the message must go by UDP instead, i.e. the peer hasn't opened our ring or
+  // has died, or it is full or the message is too large for it.
+  bool TrySend(const SerialisedMessage& message) {
+    return outbound_->ConsumerAttached() && outbound_->TryPush(message);
+  }
+  // Runs 'handler' on the io_service, as a send completion would be.
+  template <typename Handler>
+  void Post(Handler handler) {
+    io_service_.post(std::move(handler));
+  }
+
+ private:
+  boost::asio::io_service& io_service_;
+  std::unique_ptr<SharedMemoryRing> outbound_;
+  std::shared_ptr<SharedMemoryPoller> poller_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_SHARED_MEMORY_RING_H_
@@ -0,0 +1,143 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/signature_scheme.h"
+
+#include <string>
+
+#ifdef MAIDSAFE_ROUTING_ED25519
+#include "sodium.h"
+#endif
+
+#include "maidsafe/common/error.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace {
+
+class RsaSigner : public Signer {
+ public:
+  explicit RsaSigner(asymm::PrivateKey private_key) : private_key_(std::move(private_key)) {}
+  SignatureScheme Scheme() const override { return SignatureScheme::kRsa; }
+  asymm::Signature Sign(const SerialisedMessage& message) const override {
+    return asymm::Sign(asymm::PlainText(message), private_key_);
+  }
+
+ private:
+  const asymm::PrivateKey private_key_;
+};
+
+class RsaVerifier : public Verifier {
+ public:
+  explicit RsaVerifier(asymm::PublicKey public_key) : public_key_(std::move(public_key)) {}
+  SignatureScheme Scheme() const override { return SignatureScheme::kRsa; }
+  bool Verify(const SerialisedMessage& message,
+              const asymm::Signature& signature) const override {
+    return asymm::CheckSignature(asymm::PlainText(message), signature, public_key_);
+  }
+
+ private:
+  const asymm::PublicKey public_key_;
+};
+
+#ifdef MAIDSAFE_ROUTING_ED25519
+void InitialiseSodium() {
+  static const bool initialised(sodium_init() >= 0);
+  if (!initialised)
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::uninitialised));
+}
+
+class Ed25519Signer : public Signer {
+ public:
+  explicit Ed25519Signer(const Ed25519SecretKey& secret_key) : secret_key_(secret_key) {}
+  ~Ed25519Signer() override { sodium_memzero(secret_key_.data(), secret_key_.size()); }
+  SignatureScheme Scheme() const override { return SignatureScheme::kEd25519; }
+  asymm::Signature Sign(const SerialisedMessage& message) const override {
+    std::string signature(crypto_sign_BYTES, 0);
+    crypto_sign_detached(reinterpret_cast<unsigned char*>(&signature[0]), nullptr,
+                         message.data(), message.size(), secret_key_.data());
+    return asymm::Signature(std::move(signature));
+  }
+
+ private:
+  Ed25519SecretKey secret_key_;
+};
+
+class Ed25519Verifier : public Verifier {
+ public:
+  explicit Ed25519Verifier(const Ed25519PublicKey& public_key) : public_key_(public_key) {}
+  SignatureScheme Scheme() const override { return SignatureScheme::kEd25519; }
+  bool Verify(const SerialisedMessage& message,
+              const asymm::Signature& signature) const override {
+    const auto& bytes(signature.string());
+    return bytes.size() == crypto_sign_BYTES &&
+           crypto_sign_verify_detached(reinterpret_cast<const unsigned char*>(bytes.data()),
+                                       message.data(), message.size(), public_key_.data()) == 0;
+  }
+
+ private:
+  const Ed25519PublicKey public_key_;
+};
+#endif
+
+}  // unnamed namespace
+
+std::vector<bool> Verifier::VerifyBatch(const std::vector<SignedMessage>& messages) const {
+  std::vector<bool> valid;
+  valid.reserve(messages.size());
+  for (const auto& message : messages)
+    valid.push_back(Verify(*message.first, *message.second));
+  return valid;
+}
+
+std::unique_ptr<Signer> MakeRsaSigner(asymm::PrivateKey private_key) {
+  return std::unique_ptr<Signer>(new RsaSigner(std::move(private_key)));
+}
+
+std::unique_ptr<Verifier> MakeRsaVerifier(asymm::PublicKey public_key) {
+  if (!asymm::ValidateKey(public_key))
+    return nullptr;
+  return std::unique_ptr<Verifier>(new RsaVerifier(std::move(public_key)));
+}
+
+#ifdef MAIDSAFE_ROUTING_ED25519
+std::pair<Ed25519PublicKey, Ed25519SecretKey> GenerateEd25519KeyPair() {
+  static_assert(crypto_sign_PUBLICKEYBYTES == sizeof(Ed25519PublicKey), "");
+  static_assert(crypto_sign_SECRETKEYBYTES == sizeof(Ed25519SecretKey), "");
+  InitialiseSodium();
+  std::pair<Ed25519PublicKey, Ed25519SecretKey> keys;
+  crypto_sign_keypair(keys.first.data(), keys.second.data());
+  return keys;
+}
+
+std::unique_ptr<Signer> MakeEd25519Signer(const Ed25519SecretKey& secret_key) {
+  InitialiseSodium();
+  return std::unique_ptr<Signer>(new Ed25519Signer(secret_key));
+}
+
+std::unique_ptr<Verifier> MakeEd25519Verifier(const Ed25519PublicKey& public_key) {
+  InitialiseSodium();
+  return std::unique_ptr<Verifier>(new Ed25519Verifier(public_key));
+}
+#endif
+
+}  // namespace routing
+
+}  // namespace maidsafe
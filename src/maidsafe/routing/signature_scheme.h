@@ -0,0 +1,81 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_SIGNATURE_SCHEME_H_
+#define MAIDSAFE_ROUTING_SIGNATURE_SCHEME_H_
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "maidsafe/common/rsa.h"
+
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Algorithm a MessageHeader's signature was made with.  Values are fixed, as they go on the wire.
+enum class SignatureScheme : uint8_t { kRsa = 0, kEd25519 = 1 };
+
+// Signs messages with one private key.  Implementations are immutable, so can be shared between
+// threads.
+class Signer {
+ public:
+  virtual ~Signer() = default;
+  virtual SignatureScheme Scheme() const = 0;
+  virtual asymm::Signature Sign(const SerialisedMessage& message) const = 0;
+};
+
+// Checks signatures against one public key.  Implementations are immutable, so can be shared
+// between threads.
+class Verifier {
+ public:
+  using SignedMessage = std::pair<const SerialisedMessage*, const asymm::Signature*>;
+
+  virtual ~Verifier() = default;
+  virtual SignatureScheme Scheme() const = 0;
+  virtual bool Verify(const SerialisedMessage& message,
+                      const asymm::Signature& signature) const = 0;
+  // Checks each of 'messages', returning whether each is validly signed.  Checks them one at a time
+  // unless overridden by a scheme which can do better.
+  virtual std::vector<bool> VerifyBatch(const std::vector<SignedMessage>& messages) const;
+};
+
+std::unique_ptr<Signer> MakeRsaSigner(asymm::PrivateKey private_key);
+// Returns null if 'public_key' isn't a valid key.
+std::unique_ptr<Verifier> MakeRsaVerifier(asymm::PublicKey public_key);
+
+#ifdef MAIDSAFE_ROUTING_ED25519
+// Ed25519 keys can't yet be carried by passport fobs, so are handled as raw bytes.
+using Ed25519PublicKey = std::array<byte, 32>;
+using Ed25519SecretKey = std::array<byte, 64>;
+
+std::pair<Ed25519PublicKey, Ed25519SecretKey> GenerateEd25519KeyPair();
+std::unique_ptr<Signer> MakeEd25519Signer(const Ed25519SecretKey& secret_key);
+std::unique_ptr<Verifier> MakeEd25519Verifier(const Ed25519PublicKey& public_key);
+#endif
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_SIGNATURE_SCHEME_H_
@@ -69,6 +69,34 @@ TEST(RoutingTest, BEH_AccumulatorAdd) {
   EXPECT_FALSE(accumulator.HaveName(2));
 }
 
+TEST(RoutingTest, BEH_AccumulatorParts) {
+  Accumulator<int, uint32_t> accumulator(std::chrono::minutes(1), 2U);
+  EXPECT_EQ(0U, accumulator.parts());
+  auto sender(MakeIdentity());
+  EXPECT_FALSE(!!accumulator.Add(1, 3UL, sender));
+  EXPECT_FALSE(!!accumulator.Add(2, 3UL, sender));
+  EXPECT_TRUE(!!accumulator.Add(1, 3UL, MakeIdentity()));
+  EXPECT_EQ(2U, accumulator.size());
+  EXPECT_EQ(3U, accumulator.parts());
+  // a repeat from the same sender is not held twice
+  EXPECT_FALSE(!!accumulator.Add(2, 3UL, sender));
+  EXPECT_EQ(3U, accumulator.parts());
+  accumulator.Delete(1);
+  EXPECT_EQ(1U, accumulator.parts());
+}
+
+TEST(RoutingTest, BEH_AccumulatorReplacesSendersValue) {
+  Accumulator<int, uint32_t> accumulator(std::chrono::minutes(1), 2U);
+  auto sender(MakeIdentity());
+  EXPECT_FALSE(!!accumulator.Add(1, 3UL, sender));
+  EXPECT_FALSE(!!accumulator.Add(1, 4UL, sender));
+  EXPECT_EQ(1U, accumulator.parts());
+  EXPECT_EQ(4U, accumulator.GetAll(1)->second.at(sender));
+  const auto all(accumulator.Add(1, 5UL, MakeIdentity()));
+  ASSERT_TRUE(!!all);
+  EXPECT_EQ(4U, all->second.at(sender));
+}
+
 }  // namespace test
 
 }  // namespace routing
@@ -0,0 +1,300 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/bucket_refresh_scheduler.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+using Clock = BucketRefreshScheduler::Clock;
+
+std::vector<Address> ContactsInBuckets(const Address& our_id, int first, int last, int per_bucket) {
+  std::vector<Address> contacts;
+  for (int bucket(first); bucket <= last; ++bucket) {
+    for (int i(0); i != per_bucket; ++i)
+      contacts.push_back(BucketRefreshScheduler::RandomAddressInBucket(our_id, bucket));
+  }
+  return contacts;
+}
+
+// Nodes join and leave while messages are routed greedily, each hop going to the contact closest
+// to the destination.  Close groups are kept exact, as close group maintenance would; beyond them
+// each node holds at most 'kBucketCapacity' contacts per bucket, learned when it joins and, if
+// 'refresh' is set, from its bucket refresh lookups.
+class ChurningNetwork {
+ public:
+  static const std::size_t kBucketCapacity = 2;
+
+  ChurningNetwork(std::size_t size, bool refresh)
+      : refresh_(refresh), now_(Clock::now()), nodes_(), close_groups_() {
+    for (std::size_t i(0); i != size; ++i)
+      Join();
+  }
+
+  // Replaces 'count' random nodes with new ones and advances the clock a minute.
+  void Churn(std::size_t count) {
+    for (std::size_t i(0); i != count; ++i) {
+      auto leaving(std::begin(nodes_));
+      std::advance(leaving, RandomUint32() % nodes_.size());
+      const auto left(leaving->first);
+      nodes_.erase(leaving);
+      for (auto& node : nodes_)
+        node.second.far.erase(left);
+      Join();
+    }
+    now_ += std::chrono::minutes(1);
+    UpdateCloseGroups();
+    if (!refresh_)
+      return;
+    for (auto& node : nodes_)
+      node.second.scheduler->Tick(Contacts(node.first), now_);
+  }
+
+  // Routes from a random node to a random address.  Returns the hops taken, or -1 if routing
+  // stalled short of the node closest to the destination.
+  int Route() const {
+    const auto destination(MakeIdentity());
+    auto current(RandomNode());
+    int hops(0);
+    for (;;) {
+      auto next(current);
+      for (const auto& contact : Contacts(current)) {
+        if (CloserToTarget(contact, next, destination))
+          next = contact;
+      }
+      if (next == current)
+        break;
+      current = next;
+      ++hops;
+    }
+    return current == Closest(destination, 1).front() ? hops : -1;
+  }
+
+ private:
+  struct Node {
+    std::set<Address> far;
+    std::unique_ptr<BucketRefreshScheduler> scheduler;
+  };
+
+  void Join() {
+    const auto id(MakeIdentity());
+    Node node;
+    // a joining node connects to its bootstrap node and to the nodes its join lookup met, and
+    // only those learn of it
+    auto met(Closest(id, 2 * GroupSize));
+    if (!nodes_.empty())
+      met.push_back(RandomNode());
+    for (const auto& contact : met) {
+      node.far.insert(contact);
+      Add(contact, nodes_.at(contact), id);
+    }
+    node.scheduler.reset(new BucketRefreshScheduler(
+        id, [=](const Address& target) { Learn(id, target); }, std::chrono::minutes(15),
+        std::chrono::minutes(1), kBucketCapacity, RoutingTable::Parallelism(), now_));
+    nodes_.emplace(id, std::move(node));
+    Trim(id, nodes_.at(id));
+    close_groups_.erase(id);
+  }
+
+  // The result of a lookup of 'target' by 'node': the closest live nodes to 'target'.
+  void Learn(const Address& node, const Address& target) {
+    auto& learner(nodes_.at(node));
+    for (const auto& contact : Closest(target, kBucketCapacity))
+      Add(node, learner, contact);
+  }
+
+  void Add(const Address& id, Node& node, const Address& contact) {
+    if (contact == id)
+      return;
+    const auto bucket(CommonLeadingBits(id, contact));
+    std::size_t in_bucket(0);
+    for (const auto& known : node.far) {
+      if (CommonLeadingBits(id, known) == bucket)
+        ++in_bucket;
+    }
+    if (in_bucket < kBucketCapacity)
+      node.far.insert(contact);
+  }
+
+  void Trim(const Address& id, Node& node) {
+    std::set<Address> trimmed;
+    std::map<int, std::size_t> in_bucket;
+    for (const auto& contact : node.far) {
+      if (contact != id && in_bucket[CommonLeadingBits(id, contact)]++ < kBucketCapacity)
+        trimmed.insert(contact);
+    }
+    node.far.swap(trimmed);
+  }
+
+  void UpdateCloseGroups() {
+    close_groups_.clear();
+    for (const auto& node : nodes_) {
+      auto group(Closest(node.first, GroupSize + 1));
+      group.erase(std::remove(std::begin(group), std::end(group), node.first), std::end(group));
+      close_groups_[node.first] = group;
+    }
+  }
+
+  std::vector<Address> Contacts(const Address& id) const {
+    const auto& node(nodes_.at(id));
+    std::vector<Address> contacts(std::begin(node.far), std::end(node.far));
+    auto close_group(close_groups_.find(id));
+    if (close_group != std::end(close_groups_))
+      contacts.insert(std::end(contacts), std::begin(close_group->second),
+                      std::end(close_group->second));
+    return contacts;
+  }
+
+  std::vector<Address> Closest(const Address& target, std::size_t count) const {
+    std::vector<Address> closest;
+    for (const auto& node : nodes_)
+      closest.push_back(node.first);
+    count = std::min(count, closest.size());
+    std::partial_sort(std::begin(closest), std::begin(closest) + count, std::end(closest),
+                      [&](const Address& lhs, const Address& rhs) {
+      return CloserToTarget(lhs, rhs, target);
+    });
+    closest.resize(count);
+    return closest;
+  }
+
+  Address RandomNode() const {
+    auto node(std::begin(nodes_));
+    std::advance(node, RandomUint32() % nodes_.size());
+    return node->first;
+  }
+
+  const bool refresh_;
+  Clock::time_point now_;
+  std::map<Address, Node> nodes_;
+  std::map<Address, std::vector<Address>> close_groups_;
+};
+
+const std::size_t ChurningNetwork::kBucketCapacity;
+
+}  // unnamed namespace
+
+TEST(BucketRefreshSchedulerTest, BEH_RandomAddressInBucket) {
+  const auto our_id(MakeIdentity());
+  for (int bucket(0); bucket != static_cast<int>(Address::kSize * 8); ++bucket) {
+    EXPECT_EQ(bucket, CommonLeadingBits(
+                          our_id, BucketRefreshScheduler::RandomAddressInBucket(our_id, bucket)));
+  }
+}
+
+TEST(BucketRefreshSchedulerTest, BEH_RefreshesUnderpopulatedBuckets) {
+  const auto our_id(MakeIdentity());
+  const auto start(Clock::now());
+  std::vector<int> looked_up;
+  BucketRefreshScheduler scheduler(
+      our_id, [&](const Address& target) { looked_up.push_back(CommonLeadingBits(our_id, target)); },
+      std::chrono::minutes(15), std::chrono::minutes(1), 2, 4, start);
+  // bucket 0 is full, buckets 1 to 9 are empty and our close group lies in buckets 10 and beyond
+  auto contacts(ContactsInBuckets(our_id, 0, 0, 2));
+  auto close_group(ContactsInBuckets(our_id, 10, 10 + GroupSize - 1, 1));
+  contacts.insert(std::end(contacts), std::begin(close_group), std::end(close_group));
+
+  EXPECT_EQ(std::vector<int>({1, 2, 3, 4}), scheduler.Tick(contacts, start));
+  EXPECT_EQ(std::vector<int>({5, 6, 7, 8}), scheduler.Tick(contacts, start));
+  EXPECT_EQ(std::vector<int>({9}), scheduler.Tick(contacts, start));
+  EXPECT_TRUE(scheduler.Tick(contacts, start + std::chrono::seconds(59)).empty());
+  EXPECT_EQ(std::vector<int>({1, 2, 3, 4, 5, 6, 7, 8, 9}), looked_up);
+  EXPECT_EQ(9U, scheduler.LookupsSent());
+  // still empty a minute later, so they are tried again
+  EXPECT_EQ(std::vector<int>({1, 2, 3, 4}),
+            scheduler.Tick(contacts, start + std::chrono::minutes(1)));
+}
+
+TEST(BucketRefreshSchedulerTest, BEH_RefreshesIdleBuckets) {
+  const auto our_id(MakeIdentity());
+  const auto start(Clock::now());
+  BucketRefreshScheduler scheduler(our_id, [](const Address&) {}, std::chrono::minutes(15),
+                                   std::chrono::minutes(1), 2, 4, start);
+  auto contacts(ContactsInBuckets(our_id, 0, 9, 2));
+  auto close_group(ContactsInBuckets(our_id, 10, 10 + GroupSize - 1, 1));
+  contacts.insert(std::end(contacts), std::begin(close_group), std::end(close_group));
+
+  EXPECT_TRUE(scheduler.Tick(contacts, start).empty());
+  // buckets we hear from stay fresh
+  for (int bucket(0); bucket != 10; bucket += 2)
+    scheduler.Touch(contacts[2 * bucket], start + std::chrono::minutes(bucket + 1));
+  EXPECT_TRUE(scheduler.Tick(contacts, start + std::chrono::minutes(14)).empty());
+  EXPECT_EQ(std::vector<int>({1, 3, 5, 7}),
+            scheduler.Tick(contacts, start + std::chrono::minutes(15)));
+  EXPECT_EQ(std::vector<int>({9}), scheduler.Tick(contacts, start + std::chrono::minutes(15)));
+  EXPECT_EQ(std::vector<int>({0}), scheduler.Tick(contacts, start + std::chrono::minutes(16)));
+  // a lookup counts as activity too
+  EXPECT_TRUE(scheduler.Tick(contacts, start + std::chrono::minutes(17)).empty());
+  EXPECT_EQ(std::vector<int>({2}), scheduler.Tick(contacts, start + std::chrono::minutes(18)));
+}
+
+TEST(BucketRefreshSchedulerTest, FUNC_HopsStayLogarithmicUnderChurn) {
+  const std::size_t network_size(400), routes(300);
+  ChurningNetwork refreshed(network_size, true), unrefreshed(network_size, false);
+  // replace the whole network twice over
+  for (int round(0); round != 40; ++round) {
+    refreshed.Churn(network_size / 20);
+    unrefreshed.Churn(network_size / 20);
+  }
+
+  auto measure([&](const ChurningNetwork& network, const std::string& name) {
+    std::size_t hops(0), delivered(0);
+    int most_hops(0);
+    for (std::size_t i(0); i != routes; ++i) {
+      auto route_hops(network.Route());
+      if (route_hops < 0)
+        continue;
+      ++delivered;
+      hops += route_hops;
+      most_hops = std::max(most_hops, route_hops);
+    }
+    RecordProperty(name + "_mean_hops_x100", static_cast<int>(100 * hops / delivered));
+    RecordProperty(name + "_max_hops", most_hops);
+    RecordProperty(name + "_delivered", static_cast<int>(delivered));
+    return std::make_pair(static_cast<double>(hops) / delivered, delivered);
+  });
+  const auto with_refresh(measure(refreshed, "refreshed"));
+  const auto without_refresh(measure(unrefreshed, "unrefreshed"));
+
+  // log2(400) is under 9
+  EXPECT_LE(with_refresh.first, 9.0);
+  EXPECT_EQ(routes, with_refresh.second);
+  EXPECT_GE(with_refresh.second, without_refresh.second);
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,168 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/routing_config.h"
+
+#include <chrono>
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/test.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+TEST(RoutingConfigTest, BEH_DefaultsMatchPreviousConstants) {
+  RoutingConfig config;
+  EXPECT_NO_THROW(config.Validate());
+  EXPECT_EQ(1U, config.crux_thread_count);
+  EXPECT_EQ(4U, config.worker_thread_count);
+  EXPECT_EQ(std::chrono::minutes(20), config.filter_time_to_live);
+  EXPECT_EQ(std::chrono::minutes(60), config.cache_time_to_live);
+  EXPECT_EQ(std::chrono::minutes(20), config.sentinel_time_to_live);
+  EXPECT_EQ(std::chrono::seconds(30), config.negative_cache_time_to_live);
+  EXPECT_EQ(DefaultMaxMessageSize, config.max_message_size);
+  EXPECT_EQ(DefaultExchangeBufferSize, config.exchange_buffer_size);
+  EXPECT_EQ(DefaultHopLimit, config.hop_limit);
+  EXPECT_EQ(std::chrono::seconds(30), config.request_timeout);
+  EXPECT_EQ(256U * 1024, config.congested_peer_bytes);
+  EXPECT_EQ(1024U * 1024, config.shared_memory_ring_bytes);
+  EXPECT_EQ(8U, config.pending_accepts_per_port);
+  EXPECT_EQ(4096U, config.compress_payload_bytes);
+  EXPECT_EQ(std::chrono::seconds(5), config.lookup_round_timeout);
+  EXPECT_EQ(std::chrono::minutes(1), config.bucket_refresh_interval);
+  EXPECT_EQ(std::chrono::minutes(8), config.key_republish_interval);
+}
+
+TEST(RoutingConfigTest, BEH_Validate) {
+  {
+    RoutingConfig config;
+    config.worker_thread_count = 16;
+    config.cache_time_to_live = std::chrono::hours(6);
+    config.max_message_size = 4 * 1024 * 1024;
+    EXPECT_NO_THROW(config.Validate());
+  }
+  {
+    RoutingConfig config;
+    config.crux_thread_count = 0;
+    EXPECT_THROW(config.Validate(), common_error);
+  }
+  {
+    // the crux service has no strand, so more threads would race
+    RoutingConfig config;
+    config.crux_thread_count = 2;
+    EXPECT_THROW(config.Validate(), common_error);
+  }
+  {
+    RoutingConfig config;
+    config.worker_thread_count = 0;
+    EXPECT_THROW(config.Validate(), common_error);
+  }
+  {
+    RoutingConfig config;
+    config.filter_time_to_live = std::chrono::seconds(0);
+    EXPECT_THROW(config.Validate(), common_error);
+  }
+  {
+    RoutingConfig config;
+    config.sentinel_time_to_live = std::chrono::seconds(-1);
+    EXPECT_THROW(config.Validate(), common_error);
+  }
+  {
+    RoutingConfig config;
+    config.negative_cache_time_to_live = std::chrono::seconds(0);
+    EXPECT_THROW(config.Validate(), common_error);
+  }
+  {
+    RoutingConfig config;
+    config.negative_cache_time_to_live = config.cache_time_to_live + std::chrono::seconds(1);
+    EXPECT_THROW(config.Validate(), common_error);
+  }
+  {
+    RoutingConfig config;
+    config.max_message_size = 0;
+    EXPECT_THROW(config.Validate(), common_error);
+  }
+  {
+    RoutingConfig config;
+    config.exchange_buffer_size = config.max_message_size + 1;
+    EXPECT_THROW(config.Validate(), common_error);
+  }
+  {
+    RoutingConfig config;
+    config.exchange_buffer_size = 16;
+    EXPECT_THROW(config.Validate(), common_error);
+  }
+  {
+    RoutingConfig config;
+    config.hop_limit = 0;
+    EXPECT_THROW(config.Validate(), common_error);
+  }
+  {
+    RoutingConfig config;
+    config.request_timeout = std::chrono::seconds(0);
+    EXPECT_THROW(config.Validate(), common_error);
+  }
+  {
+    RoutingConfig config;
+    config.congested_peer_bytes = 0;
+    EXPECT_THROW(config.Validate(), common_error);
+  }
+  {
+    RoutingConfig config;
+    config.shared_memory_ring_bytes = 0;
+    EXPECT_NO_THROW(config.Validate());
+    config.shared_memory_ring_bytes = 1024;
+    EXPECT_THROW(config.Validate(), common_error);
+  }
+  {
+    RoutingConfig config;
+    config.pending_accepts_per_port = 0;
+    EXPECT_THROW(config.Validate(), common_error);
+    config.pending_accepts_per_port = 1000;
+    EXPECT_THROW(config.Validate(), common_error);
+  }
+  {
+    RoutingConfig config;
+    config.compress_payload_bytes = 0;
+    EXPECT_NO_THROW(config.Validate());
+  }
+  {
+    RoutingConfig config;
+    config.lookup_round_timeout = std::chrono::milliseconds(0);
+    EXPECT_THROW(config.Validate(), common_error);
+  }
+  {
+    RoutingConfig config;
+    config.bucket_refresh_interval = std::chrono::seconds(0);
+    EXPECT_THROW(config.Validate(), common_error);
+  }
+  {
+    RoutingConfig config;
+    config.key_republish_interval = std::chrono::seconds(-1);
+    EXPECT_THROW(config.Validate(), common_error);
+  }
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,227 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/congestion_windows.h"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+using Clock = CongestionWindows::Clock;
+
+SerialisedMessage MakeRequest() { return SerialisedMessage(16, 0); }
+
+// Sends from each of 'senders' nodes to one group behind a link serving 'capacity' requests a tick,
+// for 'ticks' ticks.  A request queued behind more than 'mark_threshold' others is marked, and its
+// response reaches the sender 'latency' ticks after it is served.  Returns the longest queue seen
+// after the first quarter of the run, and the requests served.  Without 'adapt' each sender keeps
+// the largest window CongestionWindows allows in flight, ignoring the marks.
+std::pair<size_t, size_t> SimulateBottleneck(bool adapt, int senders, size_t capacity,
+                                             size_t mark_threshold, int latency, int ticks) {
+  const size_t max_window(64);
+  struct Request {
+    int sender;
+    MessageId message_id;
+    bool marked;
+  };
+  struct Response {
+    int due;
+    Request request;
+  };
+  const Address group(MakeIdentity());
+  std::vector<std::unique_ptr<CongestionWindows>> windows;
+  std::vector<size_t> in_flight(senders, 0);
+  for (int i(0); i != senders; ++i)
+    windows.emplace_back(new CongestionWindows(std::chrono::hours(1), max_window));
+  std::deque<Request> queue;
+  std::deque<Response> responses;
+  MessageId next_id(0);
+  size_t longest_queue(0), served(0);
+  const auto start(Clock::now());
+  for (int tick(0); tick != ticks; ++tick) {
+    const auto now(start + std::chrono::milliseconds(tick));
+    while (!responses.empty() && responses.front().due <= tick) {
+      const auto& request(responses.front().request);
+      if (adapt)
+        windows[request.sender]->Acknowledge(request.message_id, request.marked, now);
+      --in_flight[request.sender];
+      responses.pop_front();
+    }
+    for (int i(0); i != senders; ++i) {
+      while (adapt ? windows[i]->TrySend(group, next_id, now) : in_flight[i] < max_window) {
+        queue.push_back(Request{i, next_id++, queue.size() > mark_threshold});
+        ++in_flight[i];
+      }
+    }
+    for (size_t i(0); i != capacity && !queue.empty(); ++i, ++served) {
+      responses.push_back(Response{tick + latency, queue.front()});
+      queue.pop_front();
+    }
+    if (tick > ticks / 4)
+      longest_queue = std::max(longest_queue, queue.size());
+  }
+  return std::make_pair(longest_queue, served);
+}
+
+}  // unnamed namespace
+
+TEST(CongestionWindowsTest, BEH_WindowLimitsRequestsInFlight) {
+  CongestionWindows windows;
+  const auto group(MakeIdentity());
+  const auto now(Clock::now());
+  for (MessageId id(0); id != CongestionWindows::kInitialWindow; ++id)
+    EXPECT_TRUE(windows.TrySend(group, id, now));
+  EXPECT_FALSE(windows.TrySend(group, 100, now));
+  EXPECT_EQ(CongestionWindows::kInitialWindow, windows.InFlight(group));
+  // other groups have windows of their own
+  EXPECT_TRUE(windows.TrySend(MakeIdentity(), 200, now));
+
+  // a held request goes out once a response frees its place, and only the first response counts
+  const auto destination(MakeIdentity());
+  EXPECT_TRUE(windows.Hold(group, 100, destination, MakeRequest()));
+  const auto released(windows.Acknowledge(0, false, now));
+  ASSERT_EQ(1U, released.size());
+  EXPECT_EQ(destination, released.front().first);
+  EXPECT_TRUE(windows.Acknowledge(0, false, now).empty());
+  EXPECT_EQ(CongestionWindows::kInitialWindow, windows.InFlight(group));
+  EXPECT_GT(windows.Window(group), static_cast<double>(CongestionWindows::kInitialWindow));
+}
+
+TEST(CongestionWindowsTest, BEH_MarkHalvesWindowOncePerRoundTrip) {
+  CongestionWindows windows;
+  const auto group(MakeIdentity());
+  const auto start(Clock::now());
+  for (MessageId id(0); id != 4; ++id)
+    ASSERT_TRUE(windows.TrySend(group, id, start));
+  windows.Acknowledge(0, true, start + std::chrono::milliseconds(10));
+  EXPECT_DOUBLE_EQ(2.0, windows.Window(group));
+  // requests sent before the cut don't cut it again
+  windows.Acknowledge(1, true, start + std::chrono::milliseconds(11));
+  EXPECT_DOUBLE_EQ(2.0, windows.Window(group));
+  EXPECT_EQ(1U, windows.Decreases());
+
+  // unmarked responses grow it by about one request per window's worth
+  windows.Acknowledge(2, false, start + std::chrono::milliseconds(12));
+  EXPECT_DOUBLE_EQ(2.5, windows.Window(group));
+  windows.Acknowledge(3, false, start + std::chrono::milliseconds(12));
+  ASSERT_TRUE(windows.TrySend(group, 4, start + std::chrono::milliseconds(20)));
+  windows.Acknowledge(4, true, start + std::chrono::milliseconds(30));
+  EXPECT_DOUBLE_EQ(1.45, windows.Window(group));
+  EXPECT_EQ(2U, windows.Decreases());
+  // never below one request in flight
+  ASSERT_TRUE(windows.TrySend(group, 5, start + std::chrono::milliseconds(40)));
+  windows.Acknowledge(5, true, start + std::chrono::milliseconds(50));
+  EXPECT_DOUBLE_EQ(1.0, windows.Window(group));
+}
+
+TEST(CongestionWindowsTest, BEH_UnansweredRequestsTreatedAsLost) {
+  CongestionWindows windows(std::chrono::seconds(1), 64, 1);
+  const auto group(MakeIdentity());
+  const auto start(Clock::now());
+  for (MessageId id(0); id != CongestionWindows::kInitialWindow; ++id)
+    ASSERT_TRUE(windows.TrySend(group, id, start));
+  const auto destination(MakeIdentity());
+  EXPECT_TRUE(windows.Hold(group, 10, destination, MakeRequest()));
+  EXPECT_FALSE(windows.Hold(group, 11, destination, MakeRequest()));
+  EXPECT_EQ(1U, windows.Dropped());
+
+  EXPECT_TRUE(windows.Expire(start + std::chrono::milliseconds(500)).empty());
+  const auto released(windows.Expire(start + std::chrono::seconds(2)));
+  ASSERT_EQ(1U, released.size());
+  EXPECT_EQ(destination, released.front().first);
+  EXPECT_DOUBLE_EQ(2.0, windows.Window(group));
+  EXPECT_EQ(1U, windows.InFlight(group));
+}
+
+TEST(CongestionWindowsTest, BEH_NamesInOneGroupShareItsWindow) {
+  const auto name(MakeIdentity());
+  EXPECT_EQ(name, CongestionWindows::GroupOf(name, 512));
+  EXPECT_EQ(Address(std::string(Address::kSize, 0)), CongestionWindows::GroupOf(name, 0));
+  auto neighbour_name(name.string());
+  neighbour_name.back() = static_cast<char>(~neighbour_name.back());
+  const auto group(CongestionWindows::GroupOf(name, 12));
+  ASSERT_EQ(group, CongestionWindows::GroupOf(Address(neighbour_name), 12));
+  EXPECT_GE(CommonLeadingBits(group, name), 12);
+
+  CongestionWindows windows;
+  const auto now(Clock::now());
+  for (MessageId id(0); id != CongestionWindows::kInitialWindow; ++id)
+    ASSERT_TRUE(windows.TrySend(group, id, now));
+  EXPECT_FALSE(windows.TrySend(CongestionWindows::GroupOf(Address(neighbour_name), 12), 10, now));
+}
+
+TEST(CongestionWindowsTest, BEH_WindowOutlivesPauses) {
+  CongestionWindows windows(std::chrono::seconds(1), 64, 256, 1, std::chrono::seconds(30));
+  const auto group(MakeIdentity());
+  const auto start(Clock::now());
+  for (MessageId id(0); id != 4; ++id)
+    ASSERT_TRUE(windows.TrySend(group, id, start));
+  windows.Acknowledge(0, true, start);
+  for (MessageId id(1); id != 4; ++id)
+    windows.Acknowledge(id, false, start);
+  const auto learned(windows.Window(group));
+  ASSERT_LT(learned, static_cast<double>(CongestionWindows::kInitialWindow));
+
+  // a pause of a few round trips keeps what was learned
+  EXPECT_TRUE(windows.Expire(start + std::chrono::seconds(5)).empty());
+  EXPECT_DOUBLE_EQ(learned, windows.Window(group));
+  EXPECT_EQ(1U, windows.size());
+  // with no room for another group, the idle one makes way
+  EXPECT_TRUE(windows.TrySend(MakeIdentity(), 10, start + std::chrono::seconds(6)));
+  EXPECT_EQ(1U, windows.size());
+  EXPECT_DOUBLE_EQ(static_cast<double>(CongestionWindows::kInitialWindow), windows.Window(group));
+
+  // a group idle for longer is forgotten
+  EXPECT_TRUE(windows.Expire(start + std::chrono::minutes(1)).empty());
+  EXPECT_EQ(0U, windows.size());
+}
+
+TEST(CongestionWindowsTest, FUNC_OverloadStaysStable) {
+  const int senders(16), latency(20), ticks(20000);
+  const size_t capacity(4), mark_threshold(64);
+  const auto adaptive(SimulateBottleneck(true, senders, capacity, mark_threshold, latency, ticks));
+  const auto fixed(SimulateBottleneck(false, senders, capacity, mark_threshold, latency, ticks));
+  RecordProperty("adaptive_longest_queue", std::to_string(adaptive.first));
+  RecordProperty("fixed_longest_queue", std::to_string(fixed.first));
+  RecordProperty("adaptive_served", std::to_string(adaptive.second));
+  // Reacting to marks keeps the queue near the marking threshold without idling the link, whereas
+  // fixed windows leave the whole excess queued at the bottleneck.
+  EXPECT_LT(adaptive.first, 4 * mark_threshold);
+  EXPECT_GT(fixed.first, 8 * mark_threshold);
+  EXPECT_GT(adaptive.second, capacity * ticks * 9 / 10);
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
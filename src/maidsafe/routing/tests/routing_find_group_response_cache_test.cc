@@ -0,0 +1,86 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/find_group_response_cache.h"
+
+#include "maidsafe/common/rsa.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+FindGroupResponseCache::Entry MakeEntry(const asymm::Keys& keys) {
+  return FindGroupResponseCache::Entry{
+      std::vector<passport::PublicPmid>(),
+      asymm::Sign(asymm::PlainText(RandomString(64)), keys.private_key)};
+}
+
+}  // unnamed namespace
+
+TEST(FindGroupResponseCacheTest, BEH_HitsWithinEpoch) {
+  const auto keys(asymm::GenerateKeyPair());
+  FindGroupResponseCache cache;
+  const auto target(MakeIdentity());
+  EXPECT_EQ(nullptr, cache.Get(target, 1));
+  auto entry(MakeEntry(keys));
+  const auto signature(entry.signature);
+  cache.Add(target, 1, std::move(entry));
+  const auto* found(cache.Get(target, 1));
+  ASSERT_NE(nullptr, found);
+  EXPECT_EQ(signature, found->signature);
+  EXPECT_EQ(nullptr, cache.Get(MakeIdentity(), 1));
+  EXPECT_EQ(1U, cache.Hits());
+  EXPECT_EQ(2U, cache.Misses());
+}
+
+TEST(FindGroupResponseCacheTest, BEH_NewEpochInvalidates) {
+  const auto keys(asymm::GenerateKeyPair());
+  FindGroupResponseCache cache;
+  const auto target(MakeIdentity());
+  cache.Add(target, 1, MakeEntry(keys));
+  EXPECT_EQ(nullptr, cache.Get(target, 2));
+  // a signature finished after the group changed again is of no further use
+  cache.Add(target, 1, MakeEntry(keys));
+  EXPECT_EQ(nullptr, cache.Get(target, 2));
+  cache.Add(target, 2, MakeEntry(keys));
+  EXPECT_NE(nullptr, cache.Get(target, 2));
+}
+
+TEST(FindGroupResponseCacheTest, BEH_DropsOldestBeyondCapacity) {
+  const auto keys(asymm::GenerateKeyPair());
+  FindGroupResponseCache cache(2);
+  const auto first(MakeIdentity()), second(MakeIdentity()), third(MakeIdentity());
+  cache.Add(first, 0, MakeEntry(keys));
+  cache.Add(second, 0, MakeEntry(keys));
+  cache.Add(third, 0, MakeEntry(keys));
+  EXPECT_EQ(nullptr, cache.Get(first, 0));
+  EXPECT_NE(nullptr, cache.Get(second, 0));
+  EXPECT_NE(nullptr, cache.Get(third, 0));
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
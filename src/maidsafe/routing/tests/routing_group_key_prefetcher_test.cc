@@ -0,0 +1,144 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/group_key_prefetcher.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+std::vector<GroupAddress> RandomGroups(size_t count) {
+  std::vector<GroupAddress> groups;
+  for (size_t i(0); i < count; ++i)
+    groups.emplace_back(MakeIdentity());
+  return groups;
+}
+
+// An address sharing exactly 'bits' leading bits with 'target'.
+Address WithCommonBits(const Address& target, int bits) {
+  auto id(target.string());
+  id[bits / 8] ^= static_cast<char>(0x80 >> (bits % 8));
+  return Address(id);
+}
+
+}  // unnamed namespace
+
+TEST(GroupKeyPrefetcherTest, BEH_SkipsRecentlyRequested) {
+  std::vector<GroupAddress> requested;
+  GroupKeyPrefetcher prefetcher([&](GroupAddress group) { requested.push_back(group); },
+                                std::chrono::minutes(1), 100, std::chrono::milliseconds(1));
+  const auto now(GroupKeyPrefetcher::Clock::now());
+  auto groups(RandomGroups(4));
+
+  EXPECT_EQ(4U, prefetcher.Prefetch(groups, now));
+  EXPECT_EQ(groups, requested);
+
+  // within the refetch interval nothing is asked for again
+  EXPECT_EQ(0U, prefetcher.Prefetch(groups, now + std::chrono::seconds(30)));
+  // after it, every group is asked for again, as churn may have changed even those whose keys we
+  // hold
+  EXPECT_EQ(4U, prefetcher.Prefetch(groups, now + std::chrono::minutes(2)));
+  EXPECT_EQ(8U, prefetcher.RequestsSent());
+}
+
+TEST(GroupKeyPrefetcherTest, BEH_TokenBucketLimitsRate) {
+  size_t sent(0);
+  GroupKeyPrefetcher prefetcher([&](GroupAddress) { ++sent; }, std::chrono::minutes(5), 5,
+                                std::chrono::seconds(1));
+  const auto now(GroupKeyPrefetcher::Clock::now());
+  auto groups(RandomGroups(8));
+
+  EXPECT_EQ(5U, prefetcher.Prefetch(groups, now));
+  EXPECT_EQ(3U, prefetcher.RequestsThrottled());
+  // no time has passed, so the bucket is still empty
+  EXPECT_EQ(0U, prefetcher.Prefetch(groups, now));
+  // two tokens are refilled after two periods
+  EXPECT_EQ(2U, prefetcher.Prefetch(groups, now + std::chrono::seconds(2)));
+  EXPECT_EQ(1U, prefetcher.Prefetch(groups, now + std::chrono::minutes(1)));
+  EXPECT_EQ(8U, sent);
+}
+
+TEST(GroupKeyPrefetcherTest, BEH_GroupsToPrefetch) {
+  GroupKeyPrefetcher prefetcher([](GroupAddress) {}, std::chrono::minutes(1), GroupSize,
+                                std::chrono::milliseconds(100), std::chrono::minutes(10));
+  const auto now(GroupKeyPrefetcher::Clock::now());
+  const int leading_bits(10);
+  const GroupAddress near_joiner(MakeIdentity()), near_leaver(MakeIdentity()),
+      elsewhere(WithCommonBits(near_joiner.data, 2));
+  prefetcher.Heard(near_joiner, now);
+  prefetcher.Heard(near_leaver, now);
+  prefetcher.Heard(elsewhere, now);
+  EXPECT_EQ(3U, prefetcher.GroupsHeard());
+
+  const auto stayed(MakeIdentity());
+  const auto joined(WithCommonBits(near_joiner.data, leading_bits + 3));
+  const auto left(WithCommonBits(near_leaver.data, leading_bits));
+  const CloseGroupDifference difference(std::vector<Address>{stayed, joined},
+                                        std::vector<Address>{stayed, left});
+  auto groups(prefetcher.GroupsToPrefetch(difference, leading_bits, now));
+  std::sort(std::begin(groups), std::end(groups));
+  std::vector<GroupAddress> expected{near_joiner, near_leaver};
+  std::sort(std::begin(expected), std::end(expected));
+  EXPECT_EQ(expected, groups);
+
+  // groups not heard from for a while are forgotten
+  EXPECT_TRUE(
+      prefetcher.GroupsToPrefetch(difference, leading_bits, now + std::chrono::minutes(11))
+          .empty());
+  EXPECT_EQ(0U, prefetcher.GroupsHeard());
+}
+
+TEST(GroupKeyPrefetcherTest, BEH_ForgetsLeastRecentlyHeard) {
+  GroupKeyPrefetcher prefetcher([](GroupAddress) {}, std::chrono::minutes(1), GroupSize,
+                                std::chrono::milliseconds(100), std::chrono::minutes(10), 2);
+  const auto now(GroupKeyPrefetcher::Clock::now());
+  auto groups(RandomGroups(3));
+  prefetcher.Heard(groups[0], now);
+  prefetcher.Heard(groups[1], now + std::chrono::seconds(1));
+  prefetcher.Heard(groups[0], now + std::chrono::seconds(2));
+  prefetcher.Heard(groups[2], now + std::chrono::seconds(3));
+  EXPECT_EQ(2U, prefetcher.GroupsHeard());
+
+  // with no leading bits required, every group heard from is affected by any change
+  const CloseGroupDifference difference(std::vector<Address>{MakeIdentity()},
+                                        std::vector<Address>());
+  auto heard(prefetcher.GroupsToPrefetch(difference, 0, now + std::chrono::seconds(4)));
+  std::sort(std::begin(heard), std::end(heard));
+  std::vector<GroupAddress> expected{groups[0], groups[2]};
+  std::sort(std::begin(expected), std::end(expected));
+  EXPECT_EQ(expected, heard);
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,193 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/group_lookup.h"
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+// In-process network in which each node knows its close group plus a couple of nodes per bucket,
+// and answers FindGroup with the closest nodes to the target it knows of.
+class SimulatedNetwork {
+ public:
+  explicit SimulatedNetwork(size_t size) : nodes_(), tables_(), dead_() {
+    for (size_t i(0); i < size; ++i)
+      nodes_.push_back(MakeIdentity());
+    for (const auto& node : nodes_) {
+      auto sorted(SortedBy(node));
+      std::set<Address> table(std::begin(sorted) + 1, std::begin(sorted) + 1 + GroupSize);
+      std::map<int, int> bucket_counts;
+      for (const auto& other : sorted) {
+        if (other != node && bucket_counts[CommonLeadingBits(node, other)]++ < 2)
+          table.insert(other);
+      }
+      tables_[node] = std::vector<Address>(std::begin(table), std::end(table));
+    }
+  }
+
+  void Kill(const Address& node) { dead_.insert(node); }
+  bool Dead(const Address& node) const { return dead_.count(node) != 0; }
+
+  std::vector<Address> FindGroup(const Address& node, const Address& target) const {
+    auto known(tables_.at(node));
+    known.push_back(node);
+    known.erase(std::remove_if(std::begin(known), std::end(known),
+                               [&](const Address& other) { return Dead(other); }),
+                std::end(known));
+    std::sort(std::begin(known), std::end(known), [&](const Address& lhs, const Address& rhs) {
+      return CloserToTarget(lhs, rhs, target);
+    });
+    known.resize(std::min(known.size(), GroupSize));
+    return known;
+  }
+
+  std::vector<Address> TrueGroup(const Address& target) const {
+    std::vector<Address> group;
+    for (const auto& node : SortedBy(target)) {
+      if (group.size() == GroupSize)
+        break;
+      if (!Dead(node))
+        group.push_back(node);
+    }
+    return group;
+  }
+
+  const Address& RandomNode() const { return nodes_[RandomUint32() % nodes_.size()]; }
+
+ private:
+  std::vector<Address> SortedBy(const Address& target) const {
+    auto sorted(nodes_);
+    std::sort(std::begin(sorted), std::end(sorted), [&](const Address& lhs, const Address& rhs) {
+      return CloserToTarget(lhs, rhs, target);
+    });
+    return sorted;
+  }
+
+  std::vector<Address> nodes_;
+  std::map<Address, std::vector<Address>> tables_;
+  std::set<Address> dead_;
+};
+
+// Runs 'lookup' to completion, delivering one response at a time and timing out a round only once
+// every live node asked has answered.
+void RunLookup(const SimulatedNetwork& network, GroupLookup& lookup,
+               std::deque<Address>& pending) {
+  lookup.Start();
+  while (!lookup.Done()) {
+    if (pending.empty()) {
+      lookup.HandleRoundTimeout();
+      continue;
+    }
+    auto node(pending.front());
+    pending.pop_front();
+    if (!network.Dead(node))
+      lookup.HandleResponse(node, network.FindGroup(node, lookup.Target()));
+  }
+}
+
+}  // unnamed namespace
+
+TEST(GroupLookupTest, FUNC_ConvergesOnCloseGroup) {
+  SimulatedNetwork network(1000);
+  size_t total_rounds(0), total_messages(0);
+  const int lookups(20);
+  for (int i(0); i != lookups; ++i) {
+    const auto target(MakeIdentity());
+    std::deque<Address> pending;
+    GroupLookup lookup(target, {network.RandomNode()},
+                       [&](const Address& node) { pending.push_back(node); });
+    RunLookup(network, lookup, pending);
+    EXPECT_EQ(network.TrueGroup(target), lookup.Result());
+    EXPECT_LE(lookup.Rounds(), 16U);
+    total_rounds += lookup.Rounds();
+    total_messages += lookup.MessagesSent();
+  }
+  RecordProperty("mean_rounds", static_cast<int>(total_rounds / lookups));
+  RecordProperty("mean_messages", static_cast<int>(total_messages / lookups));
+}
+
+TEST(GroupLookupTest, FUNC_RoutesAroundDeadNodes) {
+  SimulatedNetwork network(500);
+  const auto target(MakeIdentity());
+  // kill a third of the target's close group; they never answer and must be timed out
+  auto group(network.TrueGroup(target));
+  for (size_t i(0); i < group.size(); i += 3)
+    network.Kill(group[i]);
+
+  std::deque<Address> pending;
+  Address seed;
+  do {
+    seed = network.RandomNode();
+  } while (network.Dead(seed));
+  GroupLookup lookup(target, {seed}, [&](const Address& node) { pending.push_back(node); });
+  RunLookup(network, lookup, pending);
+  EXPECT_EQ(network.TrueGroup(target), lookup.Result());
+}
+
+TEST(GroupLookupTest, BEH_AsksAtMostParallelismPerRound) {
+  std::vector<Address> seeds;
+  for (int i(0); i != 10; ++i)
+    seeds.push_back(MakeIdentity());
+  std::vector<Address> asked;
+  GroupLookup lookup(MakeIdentity(), seeds, [&](const Address& node) { asked.push_back(node); },
+                     3, 5);
+  lookup.Start();
+  EXPECT_EQ(3U, asked.size());
+  EXPECT_EQ(1U, lookup.Rounds());
+  // the round only ends once all three have answered
+  lookup.HandleResponse(asked[0], {});
+  lookup.HandleResponse(asked[1], {});
+  EXPECT_EQ(3U, asked.size());
+  lookup.HandleResponse(asked[2], {});
+  // nobody closer was found, so the rest of the closest five are asked together
+  EXPECT_EQ(2U, lookup.Rounds());
+  EXPECT_EQ(5U, asked.size());
+  EXPECT_FALSE(lookup.Done());
+  // the two which never answer are dropped in favour of the next closest seeds
+  lookup.HandleRoundTimeout();
+  EXPECT_EQ(3U, lookup.Rounds());
+  EXPECT_EQ(7U, asked.size());
+  EXPECT_FALSE(lookup.Done());
+  lookup.HandleResponse(asked[5], {});
+  lookup.HandleResponse(asked[6], {});
+  EXPECT_TRUE(lookup.Done());
+  EXPECT_EQ(5U, lookup.Result().size());
+  EXPECT_EQ(lookup.MessagesSent(), asked.size());
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
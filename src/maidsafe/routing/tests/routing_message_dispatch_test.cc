@@ -0,0 +1,96 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/message_dispatch.h"
+
+#include "maidsafe/common/serialisation/binary_archive.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/routing/messages/messages.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+// Records which message type each entry was generated for.
+using Entry = MessageTypeTag (*)();
+using Parser = bool (*)(InputVectorStream&);
+
+template <typename Message>
+struct TagOf {
+  static Entry value() { return &MessageToTag<Message>::value; }
+};
+
+template <typename Message>
+struct ParseOnce {
+  static Parser value() {
+    return [](InputVectorStream& stream) -> bool {
+      Message message;
+      Parse(stream, message);
+      return true;
+    };
+  }
+};
+
+}  // unnamed namespace
+
+TEST(MessageDispatchTest, BEH_AllMessagesHaveOneEntryEach) {
+  const auto table(MakeDispatchTable<Entry, TagOf>(AllMessages()));
+  size_t entries(0);
+  for (size_t index(0); index < table.size(); ++index) {
+    if (!table[index])
+      continue;
+    ++entries;
+    EXPECT_EQ(static_cast<MessageTypeTag>(index), table[index]());
+  }
+  EXPECT_EQ(13U, entries);
+
+  auto connect_entry(FindDispatchEntry(table, MessageTypeTag::Connect));
+  ASSERT_TRUE(connect_entry != nullptr);
+  EXPECT_EQ(MessageTypeTag::Connect, connect_entry());
+  // types with no message class yet, and tags beyond the end of the table, have no entry
+  EXPECT_TRUE(FindDispatchEntry(table, MessageTypeTag::PostResponse) == nullptr);
+  EXPECT_TRUE(FindDispatchEntry(table, MessageTypeTag::AccountTransfer) == nullptr);
+  EXPECT_TRUE(FindDispatchEntry(table, static_cast<MessageTypeTag>(1000)) == nullptr);
+}
+
+TEST(MessageDispatchTest, BEH_DispatchParsesBody) {
+  const auto table(MakeDispatchTable<Parser, ParseOnce>(AllMessages()));
+  GetData get_data(Data::NameAndTypeId{MakeIdentity(), DataTypeId{RandomUint32()}},
+                   SourceAddress(NodeAddress(MakeIdentity()), boost::none, boost::none));
+  auto serialised(Serialise(MessageToTag<GetData>::value(), get_data));
+
+  InputVectorStream stream{serialised};
+  MessageTypeTag tag;
+  Parse(stream, tag);
+  auto parser(FindDispatchEntry(table, tag));
+  ASSERT_TRUE(parser != nullptr);
+  EXPECT_TRUE(parser(stream));
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
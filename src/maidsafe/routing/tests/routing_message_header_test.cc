@@ -0,0 +1,178 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/message_header.h"
+
+#include <chrono>
+
+#include "maidsafe/common/serialisation/binary_archive.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/routing/messages/messages.h"
+#include "maidsafe/routing/tests/utils/test_utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+TEST(MessageHeaderTest, BEH_HopLimitAndDeadlineSerialise) {
+  auto header_before(GetRandomMessageHeader());
+  EXPECT_FALSE(header_before.HopsRemaining());
+  EXPECT_FALSE(header_before.Expired());
+  header_before.SetHopLimit(DefaultHopLimit);
+  header_before.SetDeadline(std::chrono::system_clock::now() + std::chrono::minutes(1));
+
+  auto serialised(Serialise(header_before, MessageTypeTag::GetData));
+  InputVectorStream binary_input_stream{serialised};
+  MessageHeader header_after;
+  MessageTypeTag tag_after;
+  Parse(binary_input_stream, header_after, tag_after);
+
+  EXPECT_EQ(header_before, header_after);
+  ASSERT_TRUE(header_after.HopsRemaining());
+  EXPECT_EQ(DefaultHopLimit, *header_after.HopsRemaining());
+  EXPECT_FALSE(header_after.Expired());
+  EXPECT_TRUE(header_after.Expired(std::chrono::system_clock::now() + std::chrono::minutes(2)));
+}
+
+TEST(MessageHeaderTest, BEH_DecrementHopLimit) {
+  auto header(GetRandomMessageHeader());
+  // no limit set - can always be forwarded
+  EXPECT_TRUE(header.DecrementHopLimit());
+  EXPECT_FALSE(header.HopsRemaining());
+
+  header.SetHopLimit(2);
+  EXPECT_TRUE(header.DecrementHopLimit());
+  EXPECT_EQ(1U, *header.HopsRemaining());
+  EXPECT_TRUE(header.DecrementHopLimit());
+  EXPECT_EQ(0U, *header.HopsRemaining());
+  EXPECT_FALSE(header.DecrementHopLimit());
+  EXPECT_EQ(0U, *header.HopsRemaining());
+}
+
+TEST(MessageHeaderTest, BEH_ReplaceHeader) {
+  auto header(GetRandomMessageHeader());
+  header.SetHopLimit(DefaultHopLimit);
+  GetData get_data(Data::NameAndTypeId{MakeIdentity(), DataTypeId{RandomUint32()}},
+                   SourceAddress(NodeAddress(MakeIdentity()), boost::none, boost::none));
+  auto message(Serialise(header, MessageToTag<GetData>::value(), get_data));
+  const auto original_size(message.size());
+  const auto header_size(Serialise(header, MessageToTag<GetData>::value()).size());
+
+  ASSERT_TRUE(header.DecrementHopLimit());
+  ReplaceHeader(header, MessageToTag<GetData>::value(), header_size, message);
+  EXPECT_EQ(original_size, message.size());
+
+  InputVectorStream binary_input_stream{message};
+  MessageHeader parsed_header;
+  MessageTypeTag parsed_tag;
+  Parse(binary_input_stream, parsed_header, parsed_tag);
+  EXPECT_EQ(header, parsed_header);
+  EXPECT_EQ(MessageToTag<GetData>::value(), parsed_tag);
+  auto parsed_get_data(Parse<GetData>(binary_input_stream));
+  EXPECT_EQ(get_data.name_and_type_id(), parsed_get_data.name_and_type_id());
+}
+
+TEST(MessageHeaderTest, BEH_ReplaceHeaderOfAnotherSize) {
+  auto header(GetRandomMessageHeader());
+  GetData get_data(Data::NameAndTypeId{MakeIdentity(), DataTypeId{RandomUint32()}},
+                   SourceAddress(NodeAddress(MakeIdentity()), boost::none, boost::none));
+  auto message(Serialise(header, MessageToTag<GetData>::value(), get_data));
+  const auto header_size(Serialise(header, MessageToTag<GetData>::value()).size());
+
+  // setting a hop limit where there was none grows the header, so the body has to move
+  header.SetHopLimit(DefaultHopLimit);
+  ReplaceHeader(header, MessageToTag<GetData>::value(), header_size, message);
+  EXPECT_EQ(Serialise(header, MessageToTag<GetData>::value(), get_data), message);
+
+  InputVectorStream binary_input_stream{message};
+  MessageHeader parsed_header;
+  MessageTypeTag parsed_tag;
+  Parse(binary_input_stream, parsed_header, parsed_tag);
+  EXPECT_EQ(header, parsed_header);
+  EXPECT_EQ(get_data.name_and_type_id(),
+            Parse<GetData>(binary_input_stream).name_and_type_id());
+
+  EXPECT_THROW(ReplaceHeader(header, MessageToTag<GetData>::value(), message.size() + 1, message),
+               std::exception);
+}
+
+TEST(MessageHeaderTest, BEH_WireVersion) {
+  const auto header(GetRandomMessageHeader());
+  auto serialised(Serialise(header));
+  ASSERT_FALSE(serialised.empty());
+  EXPECT_EQ(kWireVersion, serialised.front());
+
+  // a header from a peer using another layout is rejected rather than misread
+  ++serialised.front();
+  InputVectorStream binary_input_stream{serialised};
+  MessageHeader parsed_header;
+  EXPECT_THROW(Parse(binary_input_stream, parsed_header), std::exception);
+}
+
+TEST(MessageHeaderTest, BEH_MarkCongestionExperienced) {
+  auto header(GetRandomMessageHeader());
+  EXPECT_FALSE(header.CongestionExperienced());
+  GetData get_data(Data::NameAndTypeId{MakeIdentity(), DataTypeId{RandomUint32()}},
+                   SourceAddress(NodeAddress(MakeIdentity()), boost::none, boost::none));
+  auto message(Serialise(header, MessageToTag<GetData>::value(), get_data));
+  const auto original_size(message.size());
+  const auto header_size(Serialise(header, MessageToTag<GetData>::value()).size());
+
+  // a forwarding node marks the message without reserialising its body
+  header.MarkCongestionExperienced();
+  ReplaceHeader(header, MessageToTag<GetData>::value(), header_size, message);
+  EXPECT_EQ(original_size, message.size());
+
+  InputVectorStream binary_input_stream{message};
+  MessageHeader parsed_header;
+  MessageTypeTag parsed_tag;
+  Parse(binary_input_stream, parsed_header, parsed_tag);
+  EXPECT_TRUE(parsed_header.CongestionExperienced());
+  EXPECT_EQ(header, parsed_header);
+  EXPECT_EQ(get_data.name_and_type_id(),
+            Parse<GetData>(binary_input_stream).name_and_type_id());
+}
+
+TEST(MessageHeaderTest, BEH_SignatureScheme) {
+  const DestinationAddress destination(std::make_pair(Destination(MakeIdentity()), boost::none));
+  const SourceAddress source(NodeAddress(MakeIdentity()), boost::none, boost::none);
+  const MessageHeader rsa(destination, source, RandomUint32(), Authority::node,
+                          asymm::Signature(RandomString(256)));
+  EXPECT_EQ(SignatureScheme::kRsa, rsa.SignedWith());
+  const MessageHeader ed25519(destination, source, RandomUint32(), Authority::node,
+                              asymm::Signature(RandomString(64)), SignatureScheme::kEd25519);
+  EXPECT_EQ(SignatureScheme::kEd25519, ed25519.SignedWith());
+
+  const auto serialised(Serialise(ed25519));
+  InputVectorStream binary_input_stream{serialised};
+  MessageHeader parsed_header;
+  Parse(binary_input_stream, parsed_header);
+  EXPECT_EQ(SignatureScheme::kEd25519, parsed_header.SignedWith());
+  EXPECT_EQ(ed25519, parsed_header);
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
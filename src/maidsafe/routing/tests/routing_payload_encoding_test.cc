@@ -0,0 +1,111 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/payload_encoding.h"
+
+#include <string>
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+// repetitive text, much like the metadata making up a lot of our traffic
+SerialisedData MakeCompressible(size_t size) {
+  SerialisedData data;
+  while (data.size() < size) {
+    const auto line("name=" + std::to_string(data.size() % 97) + ";version=1;owner=client\n");
+    data.insert(std::end(data), std::begin(line), std::end(line));
+  }
+  data.resize(size);
+  return data;
+}
+
+const size_t kMaxBytes(1024 * 1024);
+
+}  // unnamed namespace
+
+TEST(PayloadEncodingTest, BEH_CompressesLargeCompressiblePayloads) {
+  const auto original(MakeCompressible(64 * 1024));
+  EXPECT_TRUE(LooksCompressible(original));
+  auto data(original);
+  ASSERT_EQ(PayloadEncoding::kCompressed, EncodePayload(data, 4096));
+  EXPECT_LT(data.size(), original.size() / 4);
+  EXPECT_EQ(original, DecodePayload(PayloadEncoding::kCompressed, data, kMaxBytes));
+}
+
+TEST(PayloadEncodingTest, BEH_LeavesOtherPayloadsAlone) {
+  // below the threshold
+  auto data(MakeCompressible(1000));
+  EXPECT_EQ(PayloadEncoding::kNone, EncodePayload(data, 4096));
+  EXPECT_EQ(MakeCompressible(1000), data);
+  // disabled
+  data = MakeCompressible(64 * 1024);
+  EXPECT_EQ(PayloadEncoding::kNone, EncodePayload(data, 0));
+  EXPECT_EQ(MakeCompressible(64 * 1024), data);
+  // random bytes stand in for data which is already compressed or encrypted
+  const auto random(RandomBytes(64 * 1024));
+  EXPECT_FALSE(LooksCompressible(random));
+  data = random;
+  EXPECT_EQ(PayloadEncoding::kNone, EncodePayload(data, 4096));
+  EXPECT_EQ(random, data);
+  EXPECT_FALSE(LooksCompressible(RandomBytes(1000)));
+  EXPECT_TRUE(LooksCompressible(MakeCompressible(1000)));
+  // too little to judge
+  EXPECT_FALSE(LooksCompressible(MakeCompressible(100)));
+  EXPECT_EQ(random, DecodePayload(PayloadEncoding::kNone, random, kMaxBytes));
+}
+
+TEST(PayloadEncodingTest, BEH_DecodeRejectsBadInput) {
+  EXPECT_THROW(DecodePayload(static_cast<PayloadEncoding>(99), MakeCompressible(100), kMaxBytes),
+               common_error);
+  EXPECT_THROW(DecodePayload(PayloadEncoding::kCompressed, SerialisedData(), kMaxBytes),
+               common_error);
+  EXPECT_THROW(DecodePayload(PayloadEncoding::kCompressed, MakeCompressible(100), kMaxBytes),
+               common_error);
+}
+
+TEST(PayloadEncodingTest, BEH_DecodeIsBounded) {
+  // well within the limit, but inflating to many times it
+  SerialisedData bomb(16 * kMaxBytes, 0);
+  ASSERT_EQ(PayloadEncoding::kCompressed, EncodePayload(bomb, 4096));
+  ASSERT_LT(bomb.size(), kMaxBytes / 4);
+  EXPECT_THROW(DecodePayload(PayloadEncoding::kCompressed, bomb, kMaxBytes), common_error);
+
+  const auto original(MakeCompressible(64 * 1024));
+  auto data(original);
+  ASSERT_EQ(PayloadEncoding::kCompressed, EncodePayload(data, 4096));
+  EXPECT_EQ(original, DecodePayload(PayloadEncoding::kCompressed, data, original.size()));
+  EXPECT_THROW(DecodePayload(PayloadEncoding::kCompressed, data, original.size() - 1),
+               common_error);
+  EXPECT_THROW(DecodePayload(PayloadEncoding::kNone, original, original.size() - 1),
+               common_error);
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
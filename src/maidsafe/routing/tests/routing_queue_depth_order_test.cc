@@ -0,0 +1,87 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/queue_depth_order.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+const size_t kCongested(1000);
+
+// An address sharing exactly 'common_bits' leading bits with 'target' (common_bits < 8).
+Address WithCommonBits(const Address& target, int common_bits) {
+  auto id(RandomString(Address::kSize));
+  const auto target_byte(static_cast<unsigned char>(target.string()[0]));
+  const auto keep(static_cast<unsigned char>(0xFF << (8 - common_bits)));
+  const auto flip(static_cast<unsigned char>(0x80 >> common_bits));
+  id[0] = static_cast<char>(((target_byte & keep) | (~target_byte & flip)) |
+                            (static_cast<unsigned char>(id[0]) & ~(keep | flip) & 0xFF));
+  return Address(id);
+}
+
+}  // unnamed namespace
+
+TEST(QueueDepthOrderTest, BEH_CongestedPeerFollowsEquivalents) {
+  const auto target(MakeIdentity());
+  const auto closest(WithCommonBits(target, 3)), second(WithCommonBits(target, 3)),
+      third(WithCommonBits(target, 3)), further(WithCommonBits(target, 1));
+  std::map<Address, size_t> pending{{closest, 5 * kCongested}, {second, 2 * kCongested},
+                                    {third, kCongested - 1}, {further, 0}};
+  std::vector<Address> candidates{closest, second, third, further};
+  OrderByQueueDepth(target, candidates, kCongested,
+                    [&](const Address& peer) { return pending.at(peer); });
+  // uncongested first, then the congested by depth; never past a peer making more progress
+  EXPECT_EQ((std::vector<Address>{third, second, closest, further}), candidates);
+}
+
+TEST(QueueDepthOrderTest, BEH_XorOrderKeptWithoutCongestion) {
+  const auto target(MakeIdentity());
+  std::vector<Address> candidates{WithCommonBits(target, 5), WithCommonBits(target, 5),
+                                  WithCommonBits(target, 2), WithCommonBits(target, 0)};
+  const auto xor_order(candidates);
+  // below the threshold queue depth is ignored, however uneven
+  std::map<Address, size_t> pending{{candidates[0], kCongested - 1}, {candidates[1], 0},
+                                    {candidates[2], kCongested - 1}, {candidates[3], 0}};
+  OrderByQueueDepth(target, candidates, kCongested,
+                    [&](const Address& peer) { return pending.at(peer); });
+  EXPECT_EQ(xor_order, candidates);
+
+  // a congested peer making more progress is still preferred to an idle one making less
+  pending[candidates[0]] = pending[candidates[1]] = 10 * kCongested;
+  OrderByQueueDepth(target, candidates, kCongested,
+                    [&](const Address& peer) { return pending.at(peer); });
+  EXPECT_EQ(xor_order, candidates);
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
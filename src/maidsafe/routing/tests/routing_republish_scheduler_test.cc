@@ -0,0 +1,109 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/republish_scheduler.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "maidsafe/common/test.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+using Clock = RepublishScheduler::Clock;
+
+TEST(RepublishSchedulerTest, BEH_RepublishesWithinJitteredInterval) {
+  const auto start(Clock::now());
+  int republishes(0);
+  RepublishScheduler scheduler([&] { ++republishes; }, std::chrono::minutes(8), 0.25,
+                               std::chrono::minutes(2), start);
+  EXPECT_GE(scheduler.Due(), start);
+  EXPECT_LE(scheduler.Due(), start + std::chrono::minutes(8));
+  EXPECT_FALSE(scheduler.OnTimer(scheduler.Due() - std::chrono::seconds(1)));
+  EXPECT_EQ(0, republishes);
+
+  for (int i(0); i != 100; ++i) {
+    const auto due(scheduler.Due());
+    EXPECT_TRUE(scheduler.OnTimer(due));
+    EXPECT_GE(scheduler.Due(), due + std::chrono::minutes(6));
+    EXPECT_LE(scheduler.Due(), due + std::chrono::minutes(8));
+  }
+  EXPECT_EQ(100, republishes);
+  EXPECT_EQ(100U, scheduler.Republished());
+}
+
+TEST(RepublishSchedulerTest, BEH_PiggybacksOnTrafficToGroup) {
+  const auto start(Clock::now());
+  int republishes(0);
+  RepublishScheduler scheduler([&] { ++republishes; }, std::chrono::minutes(8), 0.25,
+                               std::chrono::minutes(2), start);
+  EXPECT_TRUE(scheduler.OnTimer(scheduler.Due()));
+  const auto due(scheduler.Due());
+  EXPECT_FALSE(scheduler.OnTrafficToGroup(due - std::chrono::minutes(3)));
+  EXPECT_TRUE(scheduler.OnTrafficToGroup(due - std::chrono::minutes(1)));
+  EXPECT_EQ(2, republishes);
+  EXPECT_EQ(1U, scheduler.Piggybacked());
+  // the timer is now early and does nothing
+  EXPECT_FALSE(scheduler.OnTimer(due));
+  EXPECT_EQ(2, republishes);
+}
+
+TEST(RepublishSchedulerTest, FUNC_NodesStartedTogetherDoNotSpike) {
+  // Many nodes start at once; count republishes per minute over two hours.
+  const auto start(Clock::now());
+  const int node_count(1000);
+  const auto slot(std::chrono::seconds(60));
+  std::map<int64_t, int> per_slot;
+  Clock::time_point now(start);
+  std::vector<std::unique_ptr<RepublishScheduler>> nodes;
+  for (int i(0); i != node_count; ++i) {
+    nodes.emplace_back(new RepublishScheduler(
+        [&] { ++per_slot[std::chrono::duration_cast<std::chrono::seconds>(now - start) / slot]; },
+        std::chrono::minutes(8), 0.25, std::chrono::minutes(2), start));
+  }
+  const auto end(start + std::chrono::hours(2));
+  for (; now < end; now += std::chrono::seconds(1)) {
+    for (auto& node : nodes)
+      node->OnTimer(now);
+  }
+
+  int total(0), busiest(0);
+  for (const auto& count : per_slot) {
+    total += count.second;
+    busiest = std::max(busiest, count.second);
+  }
+  const auto slots(std::chrono::duration_cast<std::chrono::seconds>(end - start) / slot);
+  const double mean(static_cast<double>(total) / slots);
+  RecordProperty("mean_per_slot_x100", static_cast<int>(100 * mean));
+  RecordProperty("busiest_slot", busiest);
+  // one republish per node every seven minutes on average
+  EXPECT_NEAR(node_count * 120 / 7, total, node_count);
+  EXPECT_LT(busiest, 2 * mean);
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,130 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/request_coalescer.h"
+
+#include <chrono>
+#include <utility>
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+RequestCoalescer::Waiter MakeWaiter() {
+  return RequestCoalescer::Waiter{MakeIdentity(),
+                                  std::make_pair(Destination(MakeIdentity()), boost::none),
+                                  RandomUint32(), RandomBytes(100)};
+}
+
+}  // unnamed namespace
+
+TEST(RequestCoalescerTest, BEH_HoldsRequestsBehindOneInFlight) {
+  RequestCoalescer coalescer;
+  const Data::NameAndTypeId name(MakeIdentity(), DataTypeId(0));
+  const Data::NameAndTypeId other_name(MakeIdentity(), DataTypeId(0));
+  // the first request for each name is sent on
+  EXPECT_FALSE(coalescer.Join(name, MakeWaiter()));
+  EXPECT_FALSE(coalescer.Join(other_name, MakeWaiter()));
+  auto first(MakeWaiter());
+  auto second(MakeWaiter());
+  EXPECT_TRUE(coalescer.Join(name, first));
+  EXPECT_TRUE(coalescer.Join(name, second));
+  EXPECT_EQ(2U, coalescer.Coalesced());
+
+  const auto replies(coalescer.Answer(name, MakeIdentity()));
+  ASSERT_EQ(2U, replies.size());
+  EXPECT_EQ(first.message_id, replies[0].message_id);
+  EXPECT_EQ(second.from_peer, replies[1].from_peer);
+  EXPECT_EQ(second.reply_to.first.data, replies[1].reply_to.first.data);
+  EXPECT_TRUE(coalescer.Answer(other_name, MakeIdentity()).empty());
+  EXPECT_EQ(2U, coalescer.size());
+  // once responses are passing, the next request for the name is sent on again
+  EXPECT_FALSE(coalescer.Join(name, MakeWaiter()));
+  // answering leaves the held requests intact, to be forwarded if no quorum answers in time
+  const auto expired(coalescer.Expire(RequestCoalescer::Clock::now() + std::chrono::seconds(3)));
+  ASSERT_EQ(2U, expired.size());
+  EXPECT_EQ(second.request, expired[1].second.request);
+}
+
+TEST(RequestCoalescerTest, BEH_AnswersUntilQuorum) {
+  const size_t quorum(3);
+  RequestCoalescer coalescer(std::chrono::seconds(2), 1024, 64, quorum);
+  const Data::NameAndTypeId name(MakeIdentity(), DataTypeId(0));
+  EXPECT_FALSE(coalescer.Join(name, MakeWaiter()));
+  EXPECT_TRUE(coalescer.Join(name, MakeWaiter()));
+  EXPECT_TRUE(coalescer.Join(name, MakeWaiter()));
+
+  // each held request gets one copy from each distinct responder, up to a quorum of them
+  const Address first(MakeIdentity()), second(MakeIdentity()), third(MakeIdentity());
+  EXPECT_EQ(2U, coalescer.Answer(name, first).size());
+  EXPECT_TRUE(coalescer.Answer(name, first).empty());
+  EXPECT_EQ(2U, coalescer.Answer(name, second).size());
+  EXPECT_EQ(1U, coalescer.size());
+  EXPECT_EQ(2U, coalescer.Answer(name, third).size());
+  EXPECT_EQ(0U, coalescer.size());
+  EXPECT_TRUE(coalescer.Answer(name, MakeIdentity()).empty());
+}
+
+TEST(RequestCoalescerTest, BEH_ReleasesHeldRequestsAtDeadline) {
+  const auto deadline(std::chrono::seconds(2));
+  RequestCoalescer coalescer(deadline);
+  const Data::NameAndTypeId name(MakeIdentity(), DataTypeId(1));
+  const auto start(RequestCoalescer::Clock::now());
+  EXPECT_FALSE(coalescer.Join(name, MakeWaiter(), start));
+  EXPECT_TRUE(coalescer.Join(name, MakeWaiter(), start + std::chrono::seconds(1)));
+  EXPECT_TRUE(coalescer.Expire(start + deadline).empty());
+
+  // past the deadline nothing more is held behind it, and what was held is released
+  EXPECT_FALSE(coalescer.Join(name, MakeWaiter(), start + deadline + std::chrono::seconds(1)));
+  const auto expired(coalescer.Expire(start + deadline + std::chrono::seconds(1)));
+  ASSERT_EQ(1U, expired.size());
+  EXPECT_EQ(name, expired[0].first);
+  EXPECT_EQ(1U, coalescer.Expired());
+  EXPECT_EQ(0U, coalescer.size());
+}
+
+TEST(RequestCoalescerTest, BEH_Bounded) {
+  RequestCoalescer coalescer(std::chrono::seconds(2), 2, 3);
+  const Data::NameAndTypeId name(MakeIdentity(), DataTypeId(0));
+  EXPECT_FALSE(coalescer.Join(name, MakeWaiter()));
+  for (int i(0); i != 3; ++i)
+    EXPECT_TRUE(coalescer.Join(name, MakeWaiter()));
+  EXPECT_FALSE(coalescer.Join(name, MakeWaiter()));
+
+  EXPECT_FALSE(coalescer.Join(Data::NameAndTypeId(MakeIdentity(), DataTypeId(0)), MakeWaiter()));
+  const Data::NameAndTypeId untracked(MakeIdentity(), DataTypeId(0));
+  EXPECT_FALSE(coalescer.Join(untracked, MakeWaiter()));
+  EXPECT_FALSE(coalescer.Join(untracked, MakeWaiter()));
+  EXPECT_EQ(2U, coalescer.size());
+  EXPECT_EQ(3U, coalescer.Coalesced());
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,97 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/route_cache.h"
+
+#include <string>
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+// A random address sharing the first 'kPrefixBits' bits of 'other'.
+Address SamePrefix(const Address& other) {
+  auto id(RandomString(Address::kSize));
+  const auto prefix_bytes(RouteCache<int>::kPrefixBits / 8);
+  id.replace(0, prefix_bytes, other.string().substr(0, prefix_bytes));
+  return Address(id);
+}
+
+}  // unnamed namespace
+
+TEST(RouteCacheTest, BEH_HitsWithinEpoch) {
+  RouteCache<int> cache;
+  const auto destination(MakeIdentity());
+  EXPECT_EQ(nullptr, cache.Get(destination, 1));
+  cache.Add(destination, 1, 7);
+  const auto* found(cache.Get(destination, 1));
+  ASSERT_NE(nullptr, found);
+  EXPECT_EQ(7, *found);
+  EXPECT_EQ(nullptr, cache.Get(MakeIdentity(), 1));
+  EXPECT_EQ(1U, cache.Hits());
+  EXPECT_EQ(2U, cache.Misses());
+}
+
+TEST(RouteCacheTest, BEH_SharedPrefixHits) {
+  RouteCache<int> cache;
+  const auto destination(MakeIdentity());
+  cache.Add(destination, 0, 7);
+  const auto* found(cache.Get(SamePrefix(destination), 0));
+  ASSERT_NE(nullptr, found);
+  EXPECT_EQ(7, *found);
+  // the first cached value for a prefix stands until the epoch changes
+  cache.Add(SamePrefix(destination), 0, 8);
+  EXPECT_EQ(7, *cache.Get(destination, 0));
+}
+
+TEST(RouteCacheTest, BEH_NewEpochInvalidates) {
+  RouteCache<int> cache;
+  const auto destination(MakeIdentity());
+  cache.Add(destination, 1, 7);
+  EXPECT_EQ(nullptr, cache.Get(destination, 2));
+  // a route computed before the routing table changed again is of no further use
+  cache.Add(destination, 1, 7);
+  EXPECT_EQ(nullptr, cache.Get(destination, 2));
+  cache.Add(destination, 2, 8);
+  ASSERT_NE(nullptr, cache.Get(destination, 2));
+  EXPECT_EQ(8, *cache.Get(destination, 2));
+}
+
+TEST(RouteCacheTest, BEH_DropsOldestBeyondCapacity) {
+  RouteCache<int> cache(2);
+  const auto first(MakeIdentity()), second(MakeIdentity()), third(MakeIdentity());
+  cache.Add(first, 0, 1);
+  cache.Add(second, 0, 2);
+  cache.Add(third, 0, 3);
+  EXPECT_EQ(nullptr, cache.Get(first, 0));
+  EXPECT_NE(nullptr, cache.Get(second, 0));
+  EXPECT_NE(nullptr, cache.Get(third, 0));
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,119 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+
+#include "maidsafe/routing/seen_from.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+FilterType RandomKey() { return FilterType(NodeAddress(MakeIdentity()), RandomUint32()); }
+
+}  // unnamed namespace
+
+TEST(SeenFromTest, BEH_RecordsEachPeer) {
+  SeenFrom seen_from;
+  const auto key(RandomKey());
+  const Address first(MakeIdentity()), second(MakeIdentity());
+  EXPECT_FALSE(seen_from.Contains(key, first));
+  seen_from.Add(key, first);
+  seen_from.Add(key, second);
+  seen_from.Add(key, first);
+  EXPECT_EQ(1U, seen_from.size());
+  EXPECT_TRUE(seen_from.Contains(key, first));
+  EXPECT_TRUE(seen_from.Contains(key, second));
+  EXPECT_FALSE(seen_from.Contains(RandomKey(), first));
+}
+
+TEST(SeenFromTest, BEH_SuppressesForwardsToHolders) {
+  SeenFrom seen_from;
+  const auto key(RandomKey());
+  std::vector<Address> peers;
+  for (int i(0); i < 5; ++i)
+    peers.emplace_back(MakeIdentity());
+
+  // The message reaches us from peers[0], then a duplicate from peers[3] is dropped by the filter
+  // but still recorded here; neither, nor the originator, is sent it again.
+  seen_from.Add(key, peers[0]);
+  seen_from.Add(key, peers[3]);
+  std::vector<Address> targets{peers[0], peers[1], key.first.data, peers[2], peers[3], peers[4]};
+  EXPECT_EQ(3U, seen_from.RemoveHolders(key, targets));
+  EXPECT_EQ((std::vector<Address>{peers[1], peers[2], peers[4]}), targets);
+
+  // another message is sent to everyone but its originator
+  const auto other_key(RandomKey());
+  targets = peers;
+  EXPECT_EQ(0U, seen_from.RemoveHolders(other_key, targets));
+  EXPECT_EQ(peers, targets);
+}
+
+TEST(SeenFromTest, BEH_BoundsPeersPerMessage) {
+  SeenFrom seen_from(8, 2);
+  const auto key(RandomKey());
+  const Address first(MakeIdentity()), second(MakeIdentity()), third(MakeIdentity());
+  seen_from.Add(key, first);
+  seen_from.Add(key, second);
+  seen_from.Add(key, third);
+  EXPECT_TRUE(seen_from.Contains(key, first));
+  EXPECT_TRUE(seen_from.Contains(key, second));
+  EXPECT_FALSE(seen_from.Contains(key, third));
+}
+
+TEST(SeenFromTest, BEH_ForgetsOldestWhenFull) {
+  const size_t capacity(8);
+  SeenFrom seen_from(capacity);
+  const Address peer(MakeIdentity());
+  std::vector<FilterType> keys;
+  for (size_t i(0); i < 2 * capacity; ++i) {
+    keys.push_back(RandomKey());
+    seen_from.Add(keys.back(), peer);
+    EXPECT_EQ(std::min(i + 1, capacity), seen_from.size());
+  }
+  for (size_t i(0); i < capacity; ++i)
+    EXPECT_FALSE(seen_from.Contains(keys[i], peer)) << i;
+  for (size_t i(capacity); i < 2 * capacity; ++i)
+    EXPECT_TRUE(seen_from.Contains(keys[i], peer)) << i;
+}
+
+TEST(SeenFromTest, BEH_ZeroCapacity) {
+  SeenFrom seen_from(0);
+  const auto key(RandomKey());
+  const Address peer(MakeIdentity());
+  seen_from.Add(key, peer);
+  EXPECT_EQ(0U, seen_from.size());
+  EXPECT_FALSE(seen_from.Contains(key, peer));
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,260 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include <chrono>
+#include <ctime>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "maidsafe/common/identity.h"
+#include "maidsafe/common/rsa.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/common/containers/lru_cache.h"
+#include "maidsafe/common/data_types/immutable_data.h"
+#include "maidsafe/passport/types.h"
+
+#include "maidsafe/routing/message_header.h"
+#include "maidsafe/routing/sentinel.h"
+#include "maidsafe/routing/types.h"
+#include "maidsafe/routing/messages/messages.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+// Attack messages interleaved with each legitimate group message.
+struct AttackMix {
+  std::string name;
+  // Parts claiming our peer group and its real members, but carrying junk signatures, so each
+  // batch reaching quorum costs a full round of signature checks.
+  size_t forged_signatures;
+  // Single-node messages from random senders with random ids; each opens a new accumulator entry
+  // and a client key fetch.
+  size_t random_message_ids;
+  // Parts claiming a new random group each time, so each one makes us fetch a group's keys.
+  size_t key_requests;
+};
+
+struct BenchmarkResult {
+  size_t legitimate_resolved;
+  std::chrono::microseconds mean_legitimate_latency;
+  std::chrono::nanoseconds cpu_per_attack_message;
+  size_t attack_messages;
+  size_t attack_resolved;
+  size_t accumulated_parts;
+  size_t accumulated_bytes;
+  size_t key_fetches;
+};
+
+// Drives a Sentinel with a real group's signed traffic mixed with attack traffic.  Every message
+// first goes through the same pre-dispatch stage as RoutingNode::MessageReceived (header parse,
+// expiry check and duplicate filter), since that is the work every flood message costs before it
+// reaches Sentinel.
+class SentinelBenchmark {
+ public:
+  SentinelBenchmark()
+      : sentinel_([this](Address) { ++key_fetches_; },
+                  [this](GroupAddress) { ++key_fetches_; }),
+        filter_(std::chrono::minutes(20)),
+        group_address_(MakeIdentity()),
+        our_destination_(std::make_pair(Destination(MakeIdentity()), boost::none)),
+        members_(),
+        body_(),
+        key_fetches_(0),
+        accumulated_bytes_(0) {
+    for (size_t i(0); i < GroupSize; ++i)
+      members_.push_back(passport::CreatePmidAndSigner().first);
+    const ImmutableData data(NonEmptyString(RandomBytes(256)));
+    body_ = Serialise(PutData(data.TypeId(), Serialise(data)));
+    // Prime the group's keys so legitimate messages resolve as soon as a quorum arrives.
+    std::map<Address, asymm::PublicKey> public_keys;
+    for (const auto& member : members_)
+      public_keys.insert(std::make_pair(Address(member.name()), member.public_key()));
+    const auto keys(Serialise(GetGroupKeyResponse(std::move(public_keys), group_address_)));
+    const auto message_id(RandomUint32());
+    for (size_t i(0); i < QuorumSize; ++i)
+      Receive(GroupHeader(members_[i], message_id, keys), MessageTypeTag::GetGroupKeyResponse,
+              keys);
+    key_fetches_ = 0;
+    accumulated_bytes_ = 0;
+  }
+
+  BenchmarkResult Run(const AttackMix& mix, size_t rounds) {
+    BenchmarkResult result{};
+    std::chrono::steady_clock::duration legitimate_latency{};
+    std::clock_t attack_cpu(0);
+    const auto fetches_before(key_fetches_);
+    const auto parts_before(sentinel_.AccumulatedParts());
+    const auto bytes_before(accumulated_bytes_);
+    for (size_t round(0); round < rounds; ++round) {
+      // Senders sign before sending, so that work is kept out of the measurements.
+      const auto legitimate(Legitimate());
+      const auto attack(Attack(mix));
+
+      const auto legitimate_start(std::chrono::steady_clock::now());
+      for (const auto& message : legitimate) {
+        if (Receive(message.first, MessageTypeTag::PutData, message.second)) {
+          legitimate_latency += std::chrono::steady_clock::now() - legitimate_start;
+          ++result.legitimate_resolved;
+          break;
+        }
+      }
+
+      const auto attack_start(std::clock());
+      for (const auto& message : attack) {
+        if (Receive(message.first, MessageTypeTag::PutData, message.second))
+          ++result.attack_resolved;
+      }
+      attack_cpu += std::clock() - attack_start;
+      result.attack_messages += attack.size();
+    }
+    if (result.legitimate_resolved != 0) {
+      result.mean_legitimate_latency = std::chrono::duration_cast<std::chrono::microseconds>(
+          legitimate_latency / result.legitimate_resolved);
+    }
+    if (result.attack_messages != 0) {
+      result.cpu_per_attack_message = std::chrono::nanoseconds(static_cast<int64_t>(
+          1.0e9 * attack_cpu / CLOCKS_PER_SEC / result.attack_messages));
+    }
+    result.accumulated_parts = sentinel_.AccumulatedParts() - parts_before;
+    result.accumulated_bytes = accumulated_bytes_ - bytes_before;
+    result.key_fetches = key_fetches_ - fetches_before;
+    return result;
+  }
+
+ private:
+  using Message = std::pair<MessageHeader, SerialisedMessage>;
+
+  MessageHeader GroupHeader(const passport::Pmid& sender, MessageId message_id,
+                            const SerialisedMessage& body) const {
+    return MessageHeader(our_destination_,
+                         SourceAddress(NodeAddress(sender.name()), group_address_, boost::none),
+                         message_id, Authority::nae_manager,
+                         asymm::Sign(asymm::PlainText(body), sender.private_key()));
+  }
+
+  std::vector<Message> Legitimate() const {
+    std::vector<Message> messages;
+    const auto message_id(RandomUint32());
+    for (size_t i(0); i < QuorumSize; ++i)
+      messages.emplace_back(GroupHeader(members_[i], message_id, body_), body_);
+    return messages;
+  }
+
+  std::vector<Message> Attack(const AttackMix& mix) const {
+    std::vector<Message> messages;
+    auto message_id(RandomUint32());
+    for (size_t i(0); i < mix.forged_signatures; ++i) {
+      // Batches of QuorumSize share an id so that each batch reaches signature checking.
+      if (i % QuorumSize == 0)
+        message_id = RandomUint32();
+      messages.emplace_back(
+          MessageHeader(our_destination_,
+                        SourceAddress(NodeAddress(members_[i % GroupSize].name()), group_address_,
+                                      boost::none),
+                        message_id, Authority::nae_manager,
+                        asymm::Signature(RandomString(256))),
+          body_);
+    }
+    for (size_t i(0); i < mix.random_message_ids; ++i) {
+      messages.emplace_back(
+          MessageHeader(our_destination_,
+                        SourceAddress(NodeAddress(MakeIdentity()), boost::none, boost::none),
+                        RandomUint32(), Authority::client, asymm::Signature(RandomString(256))),
+          body_);
+    }
+    for (size_t i(0); i < mix.key_requests; ++i) {
+      messages.emplace_back(
+          MessageHeader(our_destination_,
+                        SourceAddress(NodeAddress(MakeIdentity()), GroupAddress(MakeIdentity()),
+                                      boost::none),
+                        RandomUint32(), Authority::nae_manager,
+                        asymm::Signature(RandomString(256))),
+          body_);
+    }
+    return messages;
+  }
+
+  // The pre-dispatch stage of RoutingNode::MessageReceived followed by Sentinel::Add.
+  bool Receive(const MessageHeader& header, MessageTypeTag tag, const SerialisedMessage& body) {
+    const auto serialised(SerialiseWithBody(header, tag, body));
+    InputVectorStream binary_input_stream{serialised};
+    MessageHeader parsed_header;
+    MessageTypeTag parsed_tag;
+    Parse(binary_input_stream, parsed_header, parsed_tag);
+    if (parsed_header.Expired() || filter_.Check(parsed_header.FilterValue()))
+      return false;
+    filter_.Add({parsed_header.FilterValue()});
+    const auto parts_before(sentinel_.AccumulatedParts());
+    auto resolved(sentinel_.Add(std::move(parsed_header), parsed_tag, body));
+    if (sentinel_.AccumulatedParts() > parts_before)
+      accumulated_bytes_ += serialised.size();
+    return static_cast<bool>(resolved);
+  }
+
+  Sentinel sentinel_;
+  LruCache<std::pair<Address, uint32_t>, void> filter_;
+  const GroupAddress group_address_;
+  const DestinationAddress our_destination_;
+  std::vector<passport::Pmid> members_;
+  SerialisedMessage body_;
+  size_t key_fetches_;
+  size_t accumulated_bytes_;
+};
+
+// Reports, for each attack mix, how long legitimate group messages take to resolve, the CPU each
+// attack message costs and how much the accumulators grow.  The assertions only check that no
+// attack mix stops legitimate traffic resolving or gets forged traffic accepted; the figures are
+// recorded as test properties so they can be compared across releases.
+TEST(SentinelBenchmarkTest, FUNC_AttackMixes) {
+  const size_t rounds(50);
+  const std::vector<AttackMix> mixes{{"baseline", 0, 0, 0},
+                                     {"forged_signatures", 4 * QuorumSize, 0, 0},
+                                     {"random_message_ids", 0, 100, 0},
+                                     {"key_requests", 0, 0, 100},
+                                     {"mixed", 2 * QuorumSize, 50, 50}};
+  SentinelBenchmark benchmark;
+  for (const auto& mix : mixes) {
+    const auto result(benchmark.Run(mix, rounds));
+    EXPECT_EQ(rounds, result.legitimate_resolved) << mix.name;
+    EXPECT_EQ(0U, result.attack_resolved) << mix.name;
+    // Every random id and every random group costs a key fetch: this is the amplification an
+    // attacker gets, and the figure a defence should drive down.
+    EXPECT_EQ(rounds * (mix.random_message_ids + mix.key_requests), result.key_fetches)
+        << mix.name;
+    RecordProperty(mix.name + "_legitimate_latency_us",
+                   static_cast<int>(result.mean_legitimate_latency.count()));
+    RecordProperty(mix.name + "_cpu_per_attack_message_ns",
+                   static_cast<int>(result.cpu_per_attack_message.count()));
+    RecordProperty(mix.name + "_accumulated_parts", static_cast<int>(result.accumulated_parts));
+    RecordProperty(mix.name + "_accumulated_kib",
+                   static_cast<int>(result.accumulated_bytes / 1024));
+    RecordProperty(mix.name + "_key_fetches", static_cast<int>(result.key_fetches));
+  }
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -27,6 +27,7 @@
 #include "maidsafe/common/utils.h"
 #include "maidsafe/common/data_types/immutable_data.h"
 
+#include "maidsafe/routing/bucket_refresh_scheduler.h"
 #include "maidsafe/routing/types.h"
 #include "maidsafe/routing/message_header.h"
 #include "maidsafe/routing/messages/messages.h"
@@ -454,6 +455,116 @@ TEST_F(SentinelFunctionalTest, FUNC_SentinelSimpleAdd) {
                                         serialised_put_data));
 }
 
+TEST_F(SentinelFunctionalTest, FUNC_DropsCopiesArrivingAfterResolution) {
+  const GroupAddress group_address(MakeIdentity());
+  SignatureGroup single_group(group_address, GroupSize, Authority::nae_manager);
+
+  // the group's keys are already held, so the message resolves as soon as a quorum arrives
+  auto serialised_get_group_response(Serialise(GetGroupKeyResponse(
+              single_group.GetPublicKeys(), single_group.SignatureGroupAddress())));
+  AddToSentinel(GenerateMessages(single_group.GetHeaders(GetOurDestinationAddress(),
+                                                         RandomUint32(),
+                                                         serialised_get_group_response),
+                                 MessageTypeTag::GetGroupKeyResponse,
+                                 serialised_get_group_response));
+
+  const ImmutableData data(NonEmptyString(RandomBytes(3)));
+  auto serialised_put_data(Serialise(PutData(data.TypeId(), Serialise(data))));
+  auto put_data_messages(GenerateMessages(
+      single_group.GetHeaders(GetOurDestinationAddress(), RandomUint32(), serialised_put_data),
+      MessageTypeTag::PutData, serialised_put_data));
+  const std::vector<SentinelAddMessage> quorum(put_data_messages.begin(),
+                                               put_data_messages.begin() + QuorumSize);
+  const std::vector<SentinelAddMessage> late(put_data_messages.begin() + QuorumSize,
+                                             put_data_messages.end());
+  AddToSentinel(quorum);
+  EXPECT_TRUE(VerifyExactlyOneResponse(GetSelectedSentinelReturns(
+      ExtractMessageTrackers(quorum))));
+  EXPECT_EQ(0U, sentinel_.LateDropped());
+
+  // the remaining copies are dropped without being accumulated or having keys fetched for them
+  const auto parts(sentinel_.AccumulatedParts());
+  AddToSentinel(late);
+  auto late_returns(GetSelectedSentinelReturns(ExtractMessageTrackers(late)));
+  EXPECT_EQ(late.size(), CountNoneSentinelReturns(late_returns));
+  EXPECT_EQ(late.size(), sentinel_.LateDropped());
+  EXPECT_EQ(parts, sentinel_.AccumulatedParts());
+  EXPECT_EQ(0, CountSendGetGroupKeyCalls(single_group.SignatureGroupAddress()));
+}
+
+TEST_F(SentinelFunctionalTest, FUNC_RefetchesKeysWhichFailToValidate) {
+  const GroupAddress group_address(MakeIdentity());
+  SignatureGroup old_members(group_address, GroupSize, Authority::nae_manager);
+  SignatureGroup new_members(group_address, GroupSize, Authority::nae_manager);
+
+  // we hold the keys of the group's members before it churned
+  auto old_keys(Serialise(GetGroupKeyResponse(old_members.GetPublicKeys(), group_address)));
+  AddToSentinel(GenerateMessages(
+      old_members.GetHeaders(GetOurDestinationAddress(), RandomUint32(), old_keys),
+      MessageTypeTag::GetGroupKeyResponse, old_keys));
+  ASSERT_TRUE(sentinel_.HaveGroupKeys(group_address));
+
+  // a message signed by its new members fails against them, so the keys are fetched again, once
+  const ImmutableData data(NonEmptyString(RandomBytes(3)));
+  auto serialised_put_data(Serialise(PutData(data.TypeId(), Serialise(data))));
+  const MessageId message_id(RandomUint32());
+  auto put_data_messages(GenerateMessages(
+      new_members.GetHeaders(GetOurDestinationAddress(), message_id, serialised_put_data),
+      MessageTypeTag::PutData, serialised_put_data));
+  AddToSentinel(put_data_messages);
+  EXPECT_EQ(put_data_messages.size(), CountNoneSentinelReturns(GetSelectedSentinelReturns(
+                                          ExtractMessageTrackers(put_data_messages))));
+  EXPECT_EQ(1, CountSendGetGroupKeyCalls(group_address));
+  EXPECT_EQ(1U, sentinel_.KeysRefetched());
+
+  // and the fresh keys resolve it
+  auto new_keys(Serialise(GetGroupKeyResponse(new_members.GetPublicKeys(), group_address)));
+  auto key_messages(GenerateMessages(
+      new_members.GetHeaders(GetOurDestinationAddress(), message_id, new_keys),
+      MessageTypeTag::GetGroupKeyResponse, new_keys));
+  AddToSentinel(key_messages);
+  EXPECT_TRUE(VerifyExactlyOneResponse(
+      GetSelectedSentinelReturns(ExtractMessageTrackers(key_messages))));
+}
+
+TEST(SentinelTest, BEH_DropsImplausibleGroupMessages) {
+  int group_key_requests(0);
+  Sentinel sentinel([](Address) {}, [&](GroupAddress) { ++group_key_requests; });
+  const GroupAddress group(MakeIdentity());
+  auto message_from([&](const Address& node) {
+    return MessageHeader(
+        DestinationAddress(std::make_pair(Destination(MakeIdentity()), boost::none)),
+        SourceAddress(NodeAddress(node), group, boost::none), RandomUint32(),
+        Authority::nae_manager);
+  });
+  const SerialisedMessage body(Serialise(RandomString(64)));
+
+  // until our close group is known, nothing is rejected
+  sentinel.Add(message_from(BucketRefreshScheduler::RandomAddressInBucket(group.data, 1)),
+               MessageTypeTag::PutData, body);
+  EXPECT_EQ(0U, sentinel.ImplausibleDropped());
+  EXPECT_EQ(1, group_key_requests);
+
+  // our close group spans 20 leading bits, so 16 are tolerated from a group member
+  sentinel.SetCloseGroupLeadingBits(20);
+  sentinel.Add(message_from(BucketRefreshScheduler::RandomAddressInBucket(group.data, 15)),
+               MessageTypeTag::PutData, body);
+  EXPECT_EQ(1U, sentinel.ImplausibleDropped());
+  EXPECT_EQ(1, group_key_requests);
+  sentinel.Add(message_from(BucketRefreshScheduler::RandomAddressInBucket(group.data, 16)),
+               MessageTypeTag::PutData, body);
+  EXPECT_EQ(1U, sentinel.ImplausibleDropped());
+  EXPECT_EQ(2, group_key_requests);
+
+  // messages from single nodes claim no group and aren't affected
+  sentinel.Add(MessageHeader(DestinationAddress(std::make_pair(Destination(MakeIdentity()),
+                                                               boost::none)),
+                             SourceAddress(NodeAddress(MakeIdentity()), boost::none, boost::none),
+                             RandomUint32(), Authority::client),
+               MessageTypeTag::PutData, body);
+  EXPECT_EQ(1U, sentinel.ImplausibleDropped());
+}
+
 }  // namespace test
 
 }  // namespace routing
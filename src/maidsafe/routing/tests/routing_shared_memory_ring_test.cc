@@ -0,0 +1,278 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/shared_memory_ring.h"
+
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef MAIDSAFE_LINUX
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "boost/asio/io_service.hpp"
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+#ifdef MAIDSAFE_LINUX
+
+namespace {
+
+std::string RandomRingName() {
+  return "/maidsafe_routing_test_" + RandomAlphaNumericString(16);
+}
+
+SerialisedMessage MakeMessage(std::size_t size) {
+  const auto bytes(RandomString(size));
+  return SerialisedMessage(std::begin(bytes), std::end(bytes));
+}
+
+// Runs 'action' in a child process which then exits without running any destructors, as though
+// it had crashed.
+template <typename Action>
+void RunInCrashingChild(Action action) {
+  const auto child(fork());
+  ASSERT_NE(-1, child);
+  if (child == 0) {
+    try {
+      action();
+    } catch (...) {
+    }
+    _exit(0);
+  }
+  ASSERT_EQ(child, waitpid(child, nullptr, 0));
+}
+
+std::size_t ThreadCount() {
+  std::size_t count(0);
+  for (boost::filesystem::directory_iterator itr("/proc/self/task"), end; itr != end; ++itr)
+    ++count;
+  return count;
+}
+
+}  // unnamed namespace
+
+TEST(SharedMemoryRingTest, BEH_PushThenPop) {
+  const auto name(RandomRingName());
+  auto producer(SharedMemoryRing::Create(name, 1000));
+  EXPECT_EQ(1024U, producer->capacity());
+  auto consumer(SharedMemoryRing::Open(name));
+  SerialisedMessage popped;
+  EXPECT_FALSE(consumer->TryPop(popped));
+
+  // enough rounds to wrap around the ring several times, with messages split across its end
+  for (int round(0); round != 20; ++round) {
+    std::vector<SerialisedMessage> pushed;
+    while (true) {
+      auto message(MakeMessage(1 + RandomUint32() % 200));
+      if (!producer->TryPush(message))
+        break;
+      pushed.push_back(std::move(message));
+    }
+    ASSERT_FALSE(pushed.empty());
+    for (const auto& message : pushed) {
+      ASSERT_TRUE(consumer->TryPop(popped));
+      EXPECT_EQ(message, popped);
+    }
+    EXPECT_FALSE(consumer->TryPop(popped));
+  }
+  // too large to ever fit
+  EXPECT_FALSE(producer->TryPush(MakeMessage(600)));
+}
+
+TEST(SharedMemoryRingTest, BEH_OpenRequiresRing) {
+  EXPECT_THROW(SharedMemoryRing::Open(RandomRingName()), common_error);
+  const auto name(RandomRingName());
+  {
+    auto producer(SharedMemoryRing::Create(name, 4096));
+  }
+  // the creator removes the segment
+  EXPECT_THROW(SharedMemoryRing::Open(name), common_error);
+}
+
+TEST(SharedMemoryRingTest, BEH_ConsumerAttached) {
+  const auto name(RandomRingName());
+  auto producer(SharedMemoryRing::Create(name, 4096));
+  EXPECT_FALSE(producer->ConsumerAttached());
+  {
+    auto consumer(SharedMemoryRing::Open(name));
+    EXPECT_TRUE(producer->ConsumerAttached());
+  }
+  EXPECT_FALSE(producer->ConsumerAttached());
+}
+
+TEST(SharedMemoryRingTest, BEH_CrashedConsumerNotAttached) {
+  const auto name(RandomRingName());
+  auto producer(SharedMemoryRing::Create(name, 4096));
+  RunInCrashingChild([&] { SharedMemoryRing::Open(name).release(); });
+  EXPECT_FALSE(producer->ConsumerAttached());
+}
+
+TEST(SharedMemoryRingTest, BEH_CreateLeavesLiveRing) {
+  const auto name(RandomRingName());
+  auto producer(SharedMemoryRing::Create(name, 4096));
+  EXPECT_THROW(SharedMemoryRing::Create(name, 4096), common_error);
+  auto consumer(SharedMemoryRing::Open(name));
+  EXPECT_TRUE(producer->TryPush(MakeMessage(10)));
+  SerialisedMessage popped;
+  EXPECT_TRUE(consumer->TryPop(popped));
+}
+
+TEST(SharedMemoryRingTest, BEH_CreateReplacesAbandonedRing) {
+  const auto name(RandomRingName());
+  RunInCrashingChild([&] { SharedMemoryRing::Create(name, 4096).release(); });
+  auto producer(SharedMemoryRing::Create(name, 4096));
+  auto consumer(SharedMemoryRing::Open(name));
+  EXPECT_TRUE(producer->ConsumerAttached());
+}
+
+TEST(SharedMemoryRingTest, FUNC_WaitingConsumer) {
+  const auto name(RandomRingName());
+  auto producer(SharedMemoryRing::Create(name, 64 * 1024));
+  auto consumer(SharedMemoryRing::Open(name));
+  auto& doorbell(SharedMemoryDoorbell::Ours());
+
+  const int kMessages(100000);
+  auto received(std::async(std::launch::async, [&] {
+    int count(0);
+    SerialisedMessage message;
+    while (count != kMessages) {
+      if (!consumer->TryPop(message)) {
+        // a push after reading the sequence ends the wait straight away
+        const auto sequence(doorbell.Sequence());
+        if (consumer->StartWaiting())
+          doorbell.Wait(sequence, std::chrono::seconds(1));
+        consumer->StopWaiting();
+        continue;
+      }
+      // messages arrive whole and in order
+      if (message.size() != sizeof(count) ||
+          std::memcmp(message.data(), &count, sizeof(count)) != 0)
+        return count;
+      ++count;
+    }
+    return count;
+  }));
+  for (int i(0); i != kMessages; ++i) {
+    SerialisedMessage message(sizeof(i));
+    std::memcpy(message.data(), &i, sizeof(i));
+    while (!producer->TryPush(message))
+      std::this_thread::yield();
+  }
+  EXPECT_EQ(kMessages, received.get());
+}
+
+TEST(SharedMemoryRingTest, FUNC_ChannelPair) {
+  boost::asio::io_service io_service;
+  const auto first_id(MakeIdentity()), second_id(MakeIdentity());
+  std::vector<SerialisedMessage> first_received, second_received;
+  SharedMemoryChannel first(io_service, first_id, second_id, 64 * 1024,
+                            [&](SerialisedMessage message) {
+                              first_received.push_back(std::move(message));
+                            });
+  SharedMemoryChannel second(io_service, second_id, first_id, 64 * 1024,
+                             [&](SerialisedMessage message) {
+                               second_received.push_back(std::move(message));
+                             });
+  const auto to_second(MakeMessage(100)), to_first(MakeMessage(200));
+  // each only sends through shared memory once the other has opened its ring
+  const auto give_up(std::chrono::steady_clock::now() + std::chrono::seconds(5));
+  bool sent_to_second(false), sent_to_first(false);
+  while (!(sent_to_second && sent_to_first) && std::chrono::steady_clock::now() < give_up) {
+    sent_to_second = sent_to_second || first.TrySend(to_second);
+    sent_to_first = sent_to_first || second.TrySend(to_first);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_TRUE(sent_to_second);
+  ASSERT_TRUE(sent_to_first);
+  while ((first_received.empty() || second_received.empty()) &&
+         std::chrono::steady_clock::now() < give_up) {
+    io_service.poll();
+    io_service.reset();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_EQ(1U, first_received.size());
+  ASSERT_EQ(1U, second_received.size());
+  EXPECT_EQ(to_first, first_received.front());
+  EXPECT_EQ(to_second, second_received.front());
+}
+
+TEST(SharedMemoryRingTest, FUNC_ChannelsShareOneReader) {
+  boost::asio::io_service io_service;
+  const auto threads_before(ThreadCount());
+  std::vector<std::unique_ptr<SharedMemoryChannel>> channels;
+  for (int i(0); i != 20; ++i) {
+    channels.emplace_back(new SharedMemoryChannel(io_service, MakeIdentity(), MakeIdentity(),
+                                                  4096, [](SerialisedMessage) {}));
+  }
+  EXPECT_EQ(threads_before + 1, ThreadCount());
+  channels.clear();
+  EXPECT_EQ(threads_before, ThreadCount());
+}
+
+TEST(SharedMemoryRingTest, BEH_ChannelWithoutPeerUsesUdp) {
+  boost::asio::io_service io_service;
+  SharedMemoryChannel channel(io_service, MakeIdentity(), MakeIdentity(), 64 * 1024,
+                              [](SerialisedMessage) {});
+  // the peer never opens our ring, e.g. it can't see our /dev/shm
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(channel.TrySend(MakeMessage(100)));
+}
+
+#endif
+
+TEST(SharedMemoryRingTest, BEH_RingNames) {
+  const auto first(MakeIdentity()), second(MakeIdentity());
+  EXPECT_NE(SharedMemoryRingName(first, second), SharedMemoryRingName(second, first));
+  EXPECT_EQ(SharedMemoryRingName(first, second), SharedMemoryRingName(first, second));
+  // must be a single path component for shm_open
+  EXPECT_EQ(std::string::npos, SharedMemoryRingName(first, second).find('/', 1));
+}
+
+TEST(SharedMemoryRingTest, BEH_HandshakeHostId) {
+  const SerialisedMessage pmid(RandomBytes(300));
+  auto handshake(pmid);
+  AppendHostId("host", handshake);
+  EXPECT_EQ("host", TakeHostId(handshake));
+  EXPECT_EQ(pmid, handshake);
+  // as sent by a node which doesn't append one
+  EXPECT_TRUE(TakeHostId(handshake).empty());
+  EXPECT_EQ(pmid, handshake);
+  AppendHostId("", handshake);
+  EXPECT_EQ(pmid, handshake);
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
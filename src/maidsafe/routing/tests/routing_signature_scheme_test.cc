@@ -0,0 +1,132 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/signature_scheme.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "maidsafe/common/rsa.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+// Signs 'count' messages with 'signer', then checks them all with 'verifier' in one batch,
+// recording the mean time taken for each under 'name'.
+void Measure(const std::string& name, const Signer& signer, const Verifier& verifier,
+             size_t count) {
+  std::vector<SerialisedMessage> messages;
+  for (size_t i(0); i < count; ++i)
+    messages.push_back(RandomBytes(256));
+  std::vector<asymm::Signature> signatures;
+  signatures.reserve(count);
+
+  auto start(std::chrono::steady_clock::now());
+  for (const auto& message : messages)
+    signatures.push_back(signer.Sign(message));
+  const auto signing(std::chrono::steady_clock::now() - start);
+
+  std::vector<Verifier::SignedMessage> batch;
+  for (size_t i(0); i < count; ++i)
+    batch.emplace_back(&messages[i], &signatures[i]);
+  start = std::chrono::steady_clock::now();
+  const auto valid(verifier.VerifyBatch(batch));
+  const auto verifying(std::chrono::steady_clock::now() - start);
+
+  EXPECT_EQ(std::vector<bool>(count, true), valid) << name;
+  const auto per_message_us([count](std::chrono::steady_clock::duration total) {
+    return static_cast<int>(
+        std::chrono::duration_cast<std::chrono::microseconds>(total).count() / count);
+  });
+  testing::Test::RecordProperty(name + "_sign_us", per_message_us(signing));
+  testing::Test::RecordProperty(name + "_verify_us", per_message_us(verifying));
+}
+
+}  // unnamed namespace
+
+TEST(SignatureSchemeTest, BEH_Rsa) {
+  const auto keys(asymm::GenerateKeyPair());
+  const auto signer(MakeRsaSigner(keys.private_key));
+  const auto verifier(MakeRsaVerifier(keys.public_key));
+  ASSERT_TRUE(!!verifier);
+  EXPECT_EQ(SignatureScheme::kRsa, signer->Scheme());
+  EXPECT_EQ(SignatureScheme::kRsa, verifier->Scheme());
+
+  const SerialisedMessage message(RandomBytes(100));
+  const auto signature(signer->Sign(message));
+  EXPECT_TRUE(verifier->Verify(message, signature));
+  auto altered(message);
+  altered[0] ^= 1;
+  EXPECT_FALSE(verifier->Verify(altered, signature));
+  const auto other_keys(asymm::GenerateKeyPair());
+  EXPECT_FALSE(MakeRsaVerifier(other_keys.public_key)->Verify(message, signature));
+
+  const std::vector<Verifier::SignedMessage> batch{{&message, &signature},
+                                                   {&altered, &signature}};
+  EXPECT_EQ(std::vector<bool>({true, false}), verifier->VerifyBatch(batch));
+
+  EXPECT_FALSE(!!MakeRsaVerifier(asymm::PublicKey()));
+}
+
+#ifdef MAIDSAFE_ROUTING_ED25519
+TEST(SignatureSchemeTest, BEH_Ed25519) {
+  const auto keys(GenerateEd25519KeyPair());
+  const auto signer(MakeEd25519Signer(keys.second));
+  const auto verifier(MakeEd25519Verifier(keys.first));
+  EXPECT_EQ(SignatureScheme::kEd25519, signer->Scheme());
+  EXPECT_EQ(SignatureScheme::kEd25519, verifier->Scheme());
+
+  const SerialisedMessage message(RandomBytes(100));
+  const auto signature(signer->Sign(message));
+  EXPECT_TRUE(verifier->Verify(message, signature));
+  auto altered(message);
+  altered[0] ^= 1;
+  EXPECT_FALSE(verifier->Verify(altered, signature));
+  EXPECT_FALSE(MakeEd25519Verifier(GenerateEd25519KeyPair().first)->Verify(message, signature));
+  // e.g. an RSA signature claiming to be Ed25519
+  EXPECT_FALSE(verifier->Verify(message, asymm::Signature(RandomString(256))));
+}
+#endif
+
+// Records the time each scheme takes to sign a message and to verify one, for comparison across
+// schemes and releases.
+TEST(SignatureSchemeTest, FUNC_SignAndVerifyCost) {
+  const size_t count(200);
+  const auto keys(asymm::GenerateKeyPair());
+  Measure("rsa", *MakeRsaSigner(keys.private_key), *MakeRsaVerifier(keys.public_key), count);
+#ifdef MAIDSAFE_ROUTING_ED25519
+  const auto ed25519_keys(GenerateEd25519KeyPair());
+  Measure("ed25519", *MakeEd25519Signer(ed25519_keys.second),
+          *MakeEd25519Verifier(ed25519_keys.first), count);
+#endif
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,234 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "maidsafe/common/make_unique.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/routing/close_group_tracker.h"
+#include "maidsafe/routing/routing_table.h"
+#include "maidsafe/routing/types.h"
+#include "maidsafe/routing/tests/utils/test_utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Nodes joining and leaving in each step of a churn replay.
+struct ChurnRate {
+  std::string name;
+  size_t joins_per_step;
+  size_t leaves_per_step;
+};
+
+struct Timing {
+  void Record(Clock::duration duration) {
+    ++count;
+    total += duration;
+    longest = std::max(longest, duration);
+  }
+  int MeanMicroseconds() const {
+    return count == 0 ? 0 : static_cast<int>(
+        std::chrono::duration_cast<std::chrono::microseconds>(total).count() / count);
+  }
+  int LongestMicroseconds() const {
+    return static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(longest).count());
+  }
+
+  size_t count = 0;
+  Clock::duration total = Clock::duration::zero();
+  Clock::duration longest = Clock::duration::zero();
+};
+
+struct ChurnResult {
+  size_t events = 0;
+  Timing add_node;
+  Timing drop_node;
+  // OurCloseGroup plus the comparison ConnectionManager makes on every add and drop.
+  Timing close_group;
+  size_t close_group_differences = 0;
+  // Calls to TargetNodes made concurrently with churn, which wait whenever churn holds the lock.
+  Timing concurrent_lookup;
+};
+
+// A population of routing tables in which every node knows of every other, as in
+// FUNC_AddManyNodesCheckChurn.  Each table is paired with the close group tracking
+// ConnectionManager does, so a replay exercises both.
+class ChurnNetwork {
+ public:
+  ChurnNetwork(size_t population, size_t observers)
+      : fob_(PublicFob()), nodes_(), observers_(observers) {
+    while (nodes_.size() < population)
+      Join(nullptr);
+  }
+
+  ChurnResult Replay(const ChurnRate& rate, size_t steps) {
+    ChurnResult result;
+    std::atomic<bool> running(true);
+    // The first 'observers_' nodes never leave, so their tables can be read from another thread
+    // while the replay runs.
+    std::vector<RoutingTable*> observed;
+    for (size_t i(0); i < observers_; ++i)
+      observed.push_back(nodes_[i].table.get());
+    std::thread reader([&] {
+      while (running) {
+        const auto target(MakeIdentity());
+        auto& table(*observed[RandomUint32() % observed.size()]);
+        const auto start(Clock::now());
+        table.TargetNodes(target);
+        result.concurrent_lookup.Record(Clock::now() - start);
+      }
+    });
+    for (size_t step(0); step < steps; ++step) {
+      for (size_t i(0); i < rate.joins_per_step; ++i)
+        Join(&result);
+      for (size_t i(0); i < rate.leaves_per_step && nodes_.size() > observers_ + GroupSize; ++i)
+        Leave(&result);
+      result.events += rate.joins_per_step + rate.leaves_per_step;
+    }
+    running = false;
+    reader.join();
+    return result;
+  }
+
+  // True if every table holds only live nodes and reports a close group of the right size.
+  bool Consistent() const {
+    for (const auto& node : nodes_) {
+      const auto size(node.table->Size());
+      if (node.table->OurCloseGroup().size() != std::min(GroupSize, size))
+        return false;
+      for (const auto& left : departed_) {
+        if (node.table->GetPublicKey(left))
+          return false;
+      }
+    }
+    return true;
+  }
+
+  size_t Size() const { return nodes_.size(); }
+
+ private:
+  struct Node {
+    std::unique_ptr<RoutingTable> table;
+    CloseGroupTracker tracker;
+  };
+
+  void Join(ChurnResult* result) {
+    Node joiner{maidsafe::make_unique<RoutingTable>(MakeIdentity()), CloseGroupTracker()};
+    for (auto& node : nodes_) {
+      Add(node, joiner.table->OurId(), result);
+      Add(joiner, node.table->OurId(), result);
+    }
+    nodes_.push_back(std::move(joiner));
+  }
+
+  void Leave(ChurnResult* result) {
+    const auto index(observers_ + RandomUint32() % (nodes_.size() - observers_));
+    const auto leaving(nodes_[index].table->OurId());
+    nodes_.erase(std::begin(nodes_) + index);
+    departed_.push_back(leaving);
+    for (auto& node : nodes_) {
+      const auto start(Clock::now());
+      node.table->DropNode(leaving);
+      if (result)
+        result->drop_node.Record(Clock::now() - start);
+      RecomputeCloseGroup(node, result);
+    }
+  }
+
+  void Add(Node& node, const Address& id, ChurnResult* result) {
+    const auto start(Clock::now());
+    const auto added(node.table->AddNode(NodeInfo(id, fob_, true)));
+    if (result)
+      result->add_node.Record(Clock::now() - start);
+    if (added.first)
+      RecomputeCloseGroup(node, result);
+  }
+
+  void RecomputeCloseGroup(Node& node, ChurnResult* result) {
+    const auto start(Clock::now());
+    std::vector<Address> group_ids;
+    for (const auto& member : node.table->OurCloseGroup())
+      group_ids.push_back(member.id);
+    const auto difference(node.tracker.Update(std::move(group_ids)));
+    if (!result)
+      return;
+    result->close_group.Record(Clock::now() - start);
+    if (difference)
+      ++result->close_group_differences;
+  }
+
+  const passport::PublicPmid fob_;
+  std::vector<Node> nodes_;
+  std::vector<Address> departed_;
+  const size_t observers_;
+};
+
+}  // unnamed namespace
+
+// Replays join/leave sequences at several rates against a population of routing tables and
+// records, per rate, add and drop latency, close group recomputation cost, how often each churn
+// event changes someone's close group, and how long lookups made concurrently on another thread
+// are held up.  The figures are recorded as test properties for comparison across changes to the
+// table; the assertions only check the tables stay consistent.
+TEST(RoutingTableBenchmarkTest, FUNC_ChurnThroughput) {
+  const size_t population(150);
+  const size_t steps(20);
+  const std::vector<ChurnRate> rates{{"steady", 1, 1},
+                                     {"growth", 3, 1},
+                                     {"exodus", 1, 3},
+                                     {"burst", 8, 8}};
+  ChurnNetwork network(population, 8);
+  for (const auto& rate : rates) {
+    const auto result(network.Replay(rate, steps));
+    EXPECT_TRUE(network.Consistent()) << rate.name;
+    EXPECT_GT(result.close_group_differences, 0U) << rate.name;
+    RecordProperty(rate.name + "_add_node_mean_us", result.add_node.MeanMicroseconds());
+    RecordProperty(rate.name + "_add_node_max_us", result.add_node.LongestMicroseconds());
+    RecordProperty(rate.name + "_drop_node_mean_us", result.drop_node.MeanMicroseconds());
+    RecordProperty(rate.name + "_drop_node_max_us", result.drop_node.LongestMicroseconds());
+    RecordProperty(rate.name + "_close_group_mean_us", result.close_group.MeanMicroseconds());
+    RecordProperty(rate.name + "_close_group_differences_per_event_x100",
+                   static_cast<int>(100 * result.close_group_differences / result.events));
+    RecordProperty(rate.name + "_concurrent_lookup_mean_us",
+                   result.concurrent_lookup.MeanMicroseconds());
+    RecordProperty(rate.name + "_concurrent_lookup_max_us",
+                   result.concurrent_lookup.LongestMicroseconds());
+    RecordProperty(rate.name + "_population", static_cast<int>(network.Size()));
+  }
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
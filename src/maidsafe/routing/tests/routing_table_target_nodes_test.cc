@@ -108,6 +108,29 @@ TEST_F(RoutingTableUnitTest, BEH_TargetNodes) {
   }
 }
 
+TEST_F(RoutingTableUnitTest, BEH_TargetNodesCachedUntilMembershipChanges) {
+  PartiallyFillTable();
+  const auto epoch(table_.Epoch());
+  const auto target(MakeIdentity());
+  const auto first(table_.TargetNodes(target));
+  EXPECT_EQ(0U, table_.RouteCacheHits());
+  const auto second(table_.TargetNodes(target));
+  EXPECT_EQ(1U, table_.RouteCacheHits());
+  ASSERT_EQ(first.size(), second.size());
+  for (size_t i(0); i != first.size(); ++i)
+    EXPECT_EQ(first[i].id, second[i].id);
+
+  // dropping an unknown contact changes nothing
+  table_.DropNode(MakeIdentity());
+  EXPECT_EQ(epoch, table_.Epoch());
+  table_.DropNode(first.front().id);
+  EXPECT_EQ(epoch + 1, table_.Epoch());
+  const auto after_drop(table_.TargetNodes(target));
+  EXPECT_EQ(1U, table_.RouteCacheHits());
+  EXPECT_TRUE(std::none_of(std::begin(after_drop), std::end(after_drop),
+                           [&](const NodeInfo& node) { return node.id == first.front().id; }));
+}
+
 }  // namespace test
 
 }  // namespace routing
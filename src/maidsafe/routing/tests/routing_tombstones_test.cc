@@ -0,0 +1,69 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/tombstones.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+TEST(TombstonesTest, BEH_ContainsAdded) {
+  Tombstones tombstones;
+  const auto group_key(std::make_pair(GroupAddress(MakeIdentity()), MessageId(RandomUint32())));
+  EXPECT_FALSE(tombstones.Contains(group_key));
+  tombstones.Add(group_key);
+  EXPECT_TRUE(tombstones.Contains(group_key));
+  tombstones.Add(group_key);
+  EXPECT_EQ(1U, tombstones.size());
+  EXPECT_FALSE(tombstones.Contains(std::make_pair(group_key.first, group_key.second + 1)));
+  // the same address and id from a single node is a different message
+  EXPECT_FALSE(tombstones.Contains(std::make_pair(NodeAddress(group_key.first.data),
+                                                  group_key.second)));
+}
+
+TEST(TombstonesTest, BEH_ForgetsOldestWhenFull) {
+  const size_t capacity(8);
+  Tombstones tombstones(capacity);
+  std::vector<std::pair<NodeAddress, MessageId>> keys;
+  for (size_t i(0); i < 2 * capacity; ++i) {
+    keys.emplace_back(NodeAddress(MakeIdentity()), MessageId(RandomUint32()));
+    tombstones.Add(keys.back());
+    EXPECT_EQ(std::min(i + 1, capacity), tombstones.size());
+  }
+  for (size_t i(0); i < capacity; ++i)
+    EXPECT_FALSE(tombstones.Contains(keys[i])) << i;
+  for (size_t i(capacity); i < 2 * capacity; ++i)
+    EXPECT_TRUE(tombstones.Contains(keys[i])) << i;
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
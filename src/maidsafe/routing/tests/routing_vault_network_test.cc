@@ -18,10 +18,14 @@
 
 
 #include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
 #include <tuple>
 #include <vector>
 
 #include "asio/use_future.hpp"
+#include "asio/ip/address_v4.hpp"
 #include "asio/ip/udp.hpp"
 #include "boost/filesystem/operations.hpp"
 #include "boost/filesystem/path.hpp"
@@ -310,6 +314,63 @@ TEST(VaultNetworkTest, FUNC_CreateNetPutGetData) {
   // n.Put<MutableData>(to, a, [](asio::error_code /* error */) {});
 }
 
+TEST(VaultNetworkTest, FUNC_NodesShareServices) {
+  // Many nodes run on the same two pools rather than each starting five threads of its own.
+  BoostAsioService crux_asio_service(1);
+  AsioService asio_service(2);
+  std::vector<std::unique_ptr<RoutingNode<VaultFacade>>> nodes;
+  for (int i(0); i != 20; ++i) {
+    nodes.emplace_back(new RoutingNode<VaultFacade>(crux_asio_service, asio_service));
+    nodes.back()->StartAccepting(static_cast<unsigned short>(0));
+  }
+  // Destroying some nodes must leave the shared services running for the others.
+  nodes.erase(nodes.begin(), nodes.begin() + 10);
+  std::promise<void> crux_still_running;
+  crux_asio_service.service().post([&] { crux_still_running.set_value(); });
+  EXPECT_EQ(std::future_status::ready,
+            crux_still_running.get_future().wait_for(std::chrono::seconds(10)));
+  nodes.clear();
+}
+
+TEST(VaultNetworkTest, FUNC_LookupCompletesBetweenConnectedNodes) {
+  // Rounds which time out would finish the lookup unanswered, so only a response can finish it.
+  RoutingConfig config;
+  config.lookup_round_timeout = std::chrono::minutes(1);
+  RoutingNode<VaultFacade> accepting(config);
+  RoutingNode<VaultFacade> joining(config);
+  unsigned short port = 8081;
+  accepting.StartAccepting(port);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  // The joining node asks the node it connects to for its close group, which is answered back
+  // over that same connection.
+  joining.AddContact(asio::ip::udp::endpoint(asio::ip::address_v4::loopback(), port));
+  const auto give_up(std::chrono::steady_clock::now() + std::chrono::seconds(20));
+  while (joining.GetCounters().join_lookup_rounds == 0 &&
+         std::chrono::steady_clock::now() < give_up)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_NE(0U, joining.GetCounters().join_lookup_rounds);
+  EXPECT_NE(0U, joining.GetCounters().join_lookup_messages);
+}
+
+namespace {
+
+// a node which tests may hand messages to as though a peer had sent them
+class DirectlyFedNode : public RoutingNode<VaultFacade> {
+ public:
+  using RoutingNode<VaultFacade>::MessageReceived;
+};
+
+}  // unnamed namespace
+
+TEST(VaultNetworkTest, BEH_ExpiredMessagesDropped) {
+  DirectlyFedNode node;
+  auto header(GetRandomMessageHeader());
+  header.SetHopLimit(DefaultHopLimit);
+  header.SetDeadline(std::chrono::system_clock::now() - std::chrono::seconds(1));
+  node.MessageReceived(MakeIdentity(), Serialise(header, MessageTypeTag::GetData));
+  EXPECT_EQ(1U, node.GetCounters().expired_dropped);
+}
+
 
 }  // namespace test
 
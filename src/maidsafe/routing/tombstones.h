@@ -0,0 +1,95 @@
+/*  Copyright 2014 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_TOMBSTONES_H_
+#define MAIDSAFE_ROUTING_TOMBSTONES_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// A fixed-size record of recently resolved (source, message id) keys, so that copies of a message
+// arriving after it has been resolved can be recognised and dropped without being accumulated
+// again.  Only a 64-bit fingerprint of each key is held; once 'capacity' keys have been added, the
+// oldest is forgotten to make room for the next.
+class Tombstones {
+ public:
+  explicit Tombstones(size_t capacity = 4096)
+      : capacity_(capacity), ring_(), next_(0), fingerprints_() {
+    ring_.reserve(capacity_);
+    fingerprints_.reserve(capacity_);
+  }
+
+  Tombstones(const Tombstones&) = delete;
+  Tombstones(Tombstones&&) = delete;
+  ~Tombstones() = default;
+  Tombstones& operator=(const Tombstones&) = delete;
+  Tombstones& operator=(Tombstones&&) = delete;
+
+  // 'SourceType' is NodeAddress or GroupAddress; the same id from a node and from a group are
+  // kept apart.
+  template <typename SourceType>
+  void Add(const std::pair<SourceType, MessageId>& key) {
+    const auto fingerprint(Fingerprint(key));
+    if (capacity_ == 0 || !fingerprints_.insert(fingerprint).second)
+      return;
+    if (ring_.size() < capacity_) {
+      ring_.push_back(fingerprint);
+    } else {
+      fingerprints_.erase(ring_[next_]);
+      ring_[next_] = fingerprint;
+    }
+    next_ = (next_ + 1) % capacity_;
+  }
+
+  template <typename SourceType>
+  bool Contains(const std::pair<SourceType, MessageId>& key) const {
+    return fingerprints_.count(Fingerprint(key)) != 0;
+  }
+
+  size_t size() const { return fingerprints_.size(); }
+
+ private:
+  template <typename SourceType>
+  static uint64_t Fingerprint(const std::pair<SourceType, MessageId>& key) {
+    const uint64_t kind(std::is_same<SourceType, GroupAddress>::value ? 1 : 0);
+    const uint64_t hash(std::hash<std::string>()(key.first.data.string()));
+    return hash ^ ((static_cast<uint64_t>(key.second) << 1 | kind) * 0x9e3779b97f4a7c15ULL);
+  }
+
+  const size_t capacity_;
+  std::vector<uint64_t> ring_;
+  size_t next_;
+  std::unordered_set<uint64_t> fingerprints_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_TOMBSTONES_H_
@@ -17,12 +17,18 @@
     use of the MaidSafe Software.                                                                 */
 
 #include <signal.h>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <string>
+
 #include "boost/filesystem.hpp"
 #include "boost/program_options.hpp"
 
 #include "maidsafe/common/crypto.h"
 #include "maidsafe/common/utils.h"
 
+#include "maidsafe/routing/routing_config.h"
 #include "maidsafe/routing/tools/commands.h"
 #include "maidsafe/routing/utils.h"
 
@@ -67,6 +73,87 @@ void OptionDependency(const po::variables_map& variables_map, const char* for_wh
   }
 }
 
+po::options_description RoutingConfigOptions() {
+  const maidsafe::routing::RoutingConfig defaults;
+  po::options_description options("Routing performance (may also be given in --config file)");
+  options.add_options()(
+      "crux_threads", po::value<unsigned>()->default_value(defaults.crux_thread_count),
+      "Threads for network I/O (must be 1)")(
+      "worker_threads", po::value<unsigned>()->default_value(defaults.worker_thread_count),
+      "Threads for request handling and crypto")(
+      "filter_ttl", po::value<int64_t>()->default_value(defaults.filter_time_to_live.count()),
+      "Seconds a message id is remembered for duplicate detection")(
+      "cache_ttl", po::value<int64_t>()->default_value(defaults.cache_time_to_live.count()),
+      "Seconds data is cached")(
+      "negative_cache_ttl",
+      po::value<int64_t>()->default_value(defaults.negative_cache_time_to_live.count()),
+      "Seconds a failed data lookup is remembered")(
+      "sentinel_ttl", po::value<int64_t>()->default_value(defaults.sentinel_time_to_live.count()),
+      "Seconds Sentinel waits for a quorum")(
+      "max_message_size", po::value<size_t>()->default_value(defaults.max_message_size),
+      "Largest message accepted, in bytes")(
+      "exchange_buffer_size", po::value<size_t>()->default_value(defaults.exchange_buffer_size),
+      "Connect handshake buffer, in bytes")(
+      "hop_limit", po::value<unsigned>()->default_value(defaults.hop_limit),
+      "Hops our messages may take")(
+      "request_timeout", po::value<int64_t>()->default_value(defaults.request_timeout.count()),
+      "Seconds after which our messages are dropped undelivered")(
+      "congested_peer_bytes", po::value<size_t>()->default_value(defaults.congested_peer_bytes),
+      "Bytes queued to a peer before an equally close one is preferred")(
+      "shared_memory_ring_bytes",
+      po::value<size_t>()->default_value(defaults.shared_memory_ring_bytes),
+      "Shared memory per peer on the same host, in bytes (0 to always use UDP)")(
+      "pending_accepts_per_port",
+      po::value<unsigned>()->default_value(defaults.pending_accepts_per_port),
+      "Accepts kept outstanding on each listening port")(
+      "compress_payload_bytes",
+      po::value<size_t>()->default_value(defaults.compress_payload_bytes),
+      "Smallest data payload compressed, in bytes (0 never to compress)")(
+      "lookup_round_timeout",
+      po::value<int64_t>()->default_value(defaults.lookup_round_timeout.count()),
+      "Milliseconds each round of the join lookup waits for answers")(
+      "bucket_refresh_interval",
+      po::value<int64_t>()->default_value(defaults.bucket_refresh_interval.count()),
+      "Seconds between checks for stale routing table buckets")(
+      "key_republish_interval",
+      po::value<int64_t>()->default_value(defaults.key_republish_interval.count()),
+      "Longest time in seconds between republishing our public key");
+  return options;
+}
+
+// Throws if any value is out of range.
+maidsafe::routing::RoutingConfig GetRoutingConfig(const po::variables_map& variables_map) {
+  maidsafe::routing::RoutingConfig config;
+  config.crux_thread_count = variables_map.at("crux_threads").as<unsigned>();
+  config.worker_thread_count = variables_map.at("worker_threads").as<unsigned>();
+  config.filter_time_to_live = std::chrono::seconds(variables_map.at("filter_ttl").as<int64_t>());
+  config.cache_time_to_live = std::chrono::seconds(variables_map.at("cache_ttl").as<int64_t>());
+  config.sentinel_time_to_live =
+      std::chrono::seconds(variables_map.at("sentinel_ttl").as<int64_t>());
+  config.negative_cache_time_to_live =
+      std::chrono::seconds(variables_map.at("negative_cache_ttl").as<int64_t>());
+  config.max_message_size = variables_map.at("max_message_size").as<size_t>();
+  config.exchange_buffer_size = variables_map.at("exchange_buffer_size").as<size_t>();
+  auto hop_limit(variables_map.at("hop_limit").as<unsigned>());
+  if (hop_limit > std::numeric_limits<maidsafe::routing::HopLimit>::max())
+    throw std::logic_error("Option 'hop_limit' is out of range.");
+  config.hop_limit = static_cast<maidsafe::routing::HopLimit>(hop_limit);
+  config.request_timeout =
+      std::chrono::seconds(variables_map.at("request_timeout").as<int64_t>());
+  config.congested_peer_bytes = variables_map.at("congested_peer_bytes").as<size_t>();
+  config.shared_memory_ring_bytes = variables_map.at("shared_memory_ring_bytes").as<size_t>();
+  config.pending_accepts_per_port = variables_map.at("pending_accepts_per_port").as<unsigned>();
+  config.compress_payload_bytes = variables_map.at("compress_payload_bytes").as<size_t>();
+  config.lookup_round_timeout =
+      std::chrono::milliseconds(variables_map.at("lookup_round_timeout").as<int64_t>());
+  config.bucket_refresh_interval =
+      std::chrono::seconds(variables_map.at("bucket_refresh_interval").as<int64_t>());
+  config.key_republish_interval =
+      std::chrono::seconds(variables_map.at("key_republish_interval").as<int64_t>());
+  config.Validate();
+  return config;
+}
+
 // volatile bool ctrlc_pressed(false);
 //  reported unused (dirvine)
 //  void CtrlCHandler(int /*a*/) {
@@ -92,7 +179,10 @@ int main(int argc, char** argv) {
         "pmids_path",
         po::value<std::string>()->default_value(
             fs::path(fs::temp_directory_path(error_code) / "pmids_list.dat").string()),
-        "Path to pmid file");
+        "Path to pmid file")(
+        "config", po::value<std::string>(), "Path to a file of routing performance options");
+    auto routing_config_options(RoutingConfigOptions());
+    options_description.add(routing_config_options);
 
     po::variables_map variables_map;
     //     po::store(po::parse_command_line(argc, argv, options_description),
@@ -100,6 +190,14 @@ int main(int argc, char** argv) {
     po::store(
         po::command_line_parser(argc, argv).options(options_description).allow_unregistered().run(),
         variables_map);
+    // command line values take precedence over those in the config file
+    if (variables_map.count("config")) {
+      std::ifstream config_file(variables_map.at("config").as<std::string>());
+      if (!config_file)
+        throw std::logic_error("Cannot read config file " +
+                               variables_map.at("config").as<std::string>());
+      po::store(po::parse_config_file(config_file, routing_config_options), variables_map);
+    }
     po::notify(variables_map);
 
     if (variables_map.count("help") || (!variables_map.count("start"))) {
@@ -140,6 +238,11 @@ int main(int argc, char** argv) {
       return 0;
     }
 
+    // GenericNode still wraps the previous routing API, so the config is validated here but cannot
+    // yet be handed to the node it creates.
+    auto routing_config(GetRoutingConfig(variables_map));
+    static_cast<void>(routing_config);
+
     ConflictingOptions(variables_map, "client", "bootstrap");
     OptionDependency(variables_map, "start", "identity_index");
     OptionDependency(variables_map, "peer", "identity_index");